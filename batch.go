@@ -0,0 +1,362 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"context"
+	"database/sql"
+	"database/sql/driver"
+	"fmt"
+	"time"
+	"unsafe"
+)
+
+// ExecBatch prepares query, executes it once for every row in rows using array binds, then closes the statement.
+// To get the driver Conn from a sql.Conn use sql.Conn.Raw
+func (conn *Conn) ExecBatch(ctx context.Context, query string, rows [][]interface{}) (*BatchResult, error) {
+	driverStmt, err := conn.PrepareContext(ctx, query)
+	if err != nil {
+		return nil, err
+	}
+	stmt := driverStmt.(*Stmt)
+
+	result, err := stmt.ExecBatch(ctx, rows)
+	closeErr := stmt.Close()
+	if err != nil {
+		return nil, err
+	}
+	if closeErr != nil {
+		return nil, closeErr
+	}
+
+	return result, nil
+}
+
+// ExecBatch executes the statement once for every row in rows in a single round trip.
+// Each placeholder is bound to a C array holding the values of that column for all rows,
+// then OCIStmtExecute is called with iters set to the number of rows.
+// All rows must have the same number of values and all non nil values of a column must convert to the same type.
+// Values can be wrapped with sql.Named to bind by name, sql.Out is not supported. At most 16777216 rows can be executed at once.
+func (stmt *Stmt) ExecBatch(ctx context.Context, rows [][]interface{}) (*BatchResult, error) {
+	if len(rows) == 0 {
+		return &BatchResult{}, nil
+	}
+	if len(rows) > maxArraySize {
+		return nil, fmt.Errorf("batch has %v rows, more than the max of %v", len(rows), maxArraySize)
+	}
+
+	stmt.ctx = ctx
+	binds, err := stmt.bindArrays(rows)
+	if err != nil {
+		return nil, err
+	}
+	defer freeBinds(binds)
+
+	// OCI_RETURN_ROW_COUNT_ARRAY makes OCI_ATTR_DML_ROW_COUNT_ARRAY available after execute
+	mode := C.ub4(C.OCI_RETURN_ROW_COUNT_ARRAY)
+	if !stmt.conn.inTransaction {
+		mode = mode | C.OCI_COMMIT_ON_SUCCESS
+	}
+
+	if stmt.ctx.Err() != nil {
+		return nil, stmt.ctx.Err()
+	}
+
+	armed := stmt.conn.watchCancel(stmt.ctx)
+	err = stmt.ociStmtExecute(C.ub4(len(rows)), mode)
+	stmt.conn.unwatchCancel(armed)
+	if err != nil && err != ErrOCISuccessWithInfo {
+		return nil, err
+	}
+
+	result := &BatchResult{}
+	result.rowsAffected, err = stmt.rowsAffected()
+	if err != nil {
+		return nil, err
+	}
+	result.rowCounts, err = stmt.dmlRowCounts(len(rows))
+	if err != nil {
+		return nil, err
+	}
+
+	return result, nil
+}
+
+// bindArrays converts rows to columns and binds each column as an array
+func (stmt *Stmt) bindArrays(rows [][]interface{}) ([]bindStruct, error) {
+	count := len(rows[0])
+	for i := 1; i < len(rows); i++ {
+		if len(rows[i]) != count {
+			return nil, fmt.Errorf("batch row %v has %v values, expected %v", i, len(rows[i]), count)
+		}
+	}
+
+	// array binds replace any buffers kept by the statement
+	stmt.streams = nil
+	for i := range stmt.binds {
+		stmt.freeKeptBind(i)
+	}
+
+	var err error
+	binds := make([]bindStruct, 0, count)
+	values := make([]interface{}, len(rows))
+
+	for i := 0; i < count; i++ {
+		if stmt.ctx.Err() != nil {
+			freeBinds(binds)
+			return nil, stmt.ctx.Err()
+		}
+
+		var name string
+		if namedArg, ok := rows[0][i].(sql.NamedArg); ok {
+			name = namedArg.Name
+		}
+
+		for j := 0; j < len(rows); j++ {
+			value := rows[j][i]
+			if namedArg, ok := value.(sql.NamedArg); ok {
+				value = namedArg.Value
+			}
+			if _, ok := value.(sql.Out); ok {
+				freeBinds(binds)
+				return nil, fmt.Errorf("sql.Out is not supported in batch for column %v", i)
+			}
+			values[j], err = driver.DefaultParameterConverter.ConvertValue(value)
+			if err != nil {
+				freeBinds(binds)
+				return nil, fmt.Errorf("convert value for batch row %v column %v - error: %v", j, i, err)
+			}
+		}
+
+		var sbind bindStruct
+		sbind, err = stmt.conn.makeArrayBind(values)
+		if err != nil {
+			// sbind may hold buffers allocated before the error
+			freeBinds(append(binds, sbind))
+			return nil, fmt.Errorf("batch column %v - error: %v", i, err)
+		}
+
+		// add to binds now so if error will be freed by freeBinds call
+		binds = append(binds, sbind)
+
+		if name == "" {
+			err = stmt.ociBindByPos(C.ub4(i+1), &binds[len(binds)-1])
+		} else {
+			err = stmt.ociBindByName([]byte(":"+name), &binds[len(binds)-1])
+		}
+		if err != nil {
+			freeBinds(binds)
+			return nil, err
+		}
+	}
+
+	return binds, nil
+}
+
+// makeArrayBind makes an array bind from the converted values of one column
+func (conn *Conn) makeArrayBind(values []interface{}) (bindStruct, error) {
+	size := len(values)
+	sbind := bindStruct{arraySize: size}
+	sbind.length = (*C.ub2)(C.malloc(C.size_t(size) * C.sizeof_ub2))
+	sbind.indicator = (*C.sb2)(C.malloc(C.size_t(size) * C.sizeof_sb2))
+	lengths := (*[1 << 28]C.ub2)(unsafe.Pointer(sbind.length))[:size:size]
+	indicators := (*[1 << 28]C.sb2)(unsafe.Pointer(sbind.indicator))[:size:size]
+
+	// the first non nil value decides the data type of the column
+	var first interface{}
+	for i := 0; i < size; i++ {
+		lengths[i] = 0
+		indicators[i] = 0
+		if values[i] == nil {
+			indicators[i] = -1 // set to null
+		} else if first == nil {
+			first = values[i]
+		}
+	}
+
+	switch first.(type) {
+
+	case nil:
+		sbind.dataType = C.SQLT_AFC
+		sbind.maxSize = 1
+		sbind.pbuf = C.malloc(C.size_t(size))
+
+	case int64, bool:
+		sbind.dataType = C.SQLT_INT
+		sbind.maxSize = 8
+		sbind.pbuf = C.malloc(C.size_t(size) * 8)
+		buffer := (*[1 << 28]C.sb8)(sbind.pbuf)[:size:size]
+		for i, value := range values {
+			switch value := value.(type) {
+			case nil:
+			case int64:
+				buffer[i] = C.sb8(value)
+				lengths[i] = 8
+			case bool: // oracle does not have bool, handle as 0/1 int
+				buffer[i] = 0
+				if value {
+					buffer[i] = 1
+				}
+				lengths[i] = 8
+			default:
+				return sbind, fmt.Errorf("row %v type %T does not match type %T", i, value, first)
+			}
+		}
+
+	case float64:
+		sbind.dataType = C.SQLT_BDOUBLE
+		sbind.maxSize = 8
+		sbind.pbuf = C.malloc(C.size_t(size) * 8)
+		buffer := (*[1 << 28]C.double)(sbind.pbuf)[:size:size]
+		for i, value := range values {
+			switch value := value.(type) {
+			case nil:
+			case float64:
+				buffer[i] = C.double(value)
+				lengths[i] = 8
+			default:
+				return sbind, fmt.Errorf("row %v type %T does not match type %T", i, value, first)
+			}
+		}
+
+	case string, []byte:
+		maxSize := 1
+		for i, value := range values {
+			var length int
+			switch value := value.(type) {
+			case nil:
+			case string:
+				length = len(value)
+			case []byte:
+				length = len(value)
+			}
+			if length > 32767 {
+				return sbind, fmt.Errorf("row %v length %v is greater than 32767", i, length)
+			}
+			if length > maxSize {
+				maxSize = length
+			}
+		}
+
+		sbind.dataType = C.SQLT_AFC
+		if _, ok := first.([]byte); ok {
+			sbind.dataType = C.SQLT_BIN
+		}
+		sbind.maxSize = C.sb4(maxSize)
+		sbind.pbuf = C.malloc(C.size_t(size) * C.size_t(maxSize))
+		for i, value := range values {
+			// the buffer of each row is sliced on its own, the whole buffer can be larger than any Go array type
+			buffer := (*[1 << 30]byte)(unsafe.Pointer(uintptr(sbind.pbuf) + uintptr(i)*uintptr(maxSize)))[:maxSize:maxSize]
+			switch value := value.(type) {
+			case nil:
+			case string:
+				if sbind.dataType != C.SQLT_AFC {
+					return sbind, fmt.Errorf("row %v type %T does not match type %T", i, value, first)
+				}
+				lengths[i] = C.ub2(copy(buffer, value))
+			case []byte:
+				if sbind.dataType != C.SQLT_BIN {
+					return sbind, fmt.Errorf("row %v type %T does not match type %T", i, value, first)
+				}
+				lengths[i] = C.ub2(copy(buffer, value))
+			default:
+				return sbind, fmt.Errorf("row %v type %T does not match type %T", i, value, first)
+			}
+		}
+
+	case time.Time:
+		// the whole column is bound as DATE only if every time can be
+		dateBindable := true
+		for i, value := range values {
+			switch value := value.(type) {
+			case nil:
+			case time.Time:
+				if dateBindable && !conn.dateBindable(&value) {
+					dateBindable = false
+				}
+			default:
+				return sbind, fmt.Errorf("row %v type %T does not match type %T", i, value, first)
+			}
+		}
+
+		if dateBindable {
+			sbind.dataType = C.SQLT_DAT
+			sbind.maxSize = 7
+			sbind.pbuf = C.malloc(C.size_t(size) * 7)
+			for i, value := range values {
+				if value, ok := value.(time.Time); ok {
+					// sliced per row like the string buffers
+					buffer := (*[7]byte)(unsafe.Pointer(uintptr(sbind.pbuf) + uintptr(i)*7))[:]
+					conn.encodeDate(buffer, &value)
+					lengths[i] = 7
+				}
+			}
+			break
+		}
+
+		sbind.dataType = C.SQLT_TIMESTAMP_TZ
+		sbind.maxSize = C.sb4(sizeOfNilPointer)
+		sbind.pbuf = C.malloc(C.size_t(size) * C.size_t(sizeOfNilPointer))
+		sbind.dateTimes = conn.environment
+		buffer := (*[1 << 28]unsafe.Pointer)(sbind.pbuf)[:size:size]
+		for i := range buffer {
+			buffer[i] = nil
+		}
+		for i, value := range values {
+			if value, ok := value.(time.Time); ok {
+				dateTimeP, err := conn.timeToPooledDateTime(&value)
+				if err != nil {
+					return sbind, fmt.Errorf("timeToPooledDateTime for row %v - error: %v", i, err)
+				}
+				buffer[i] = dateTimeP
+				lengths[i] = C.ub2(sizeOfNilPointer)
+			}
+		}
+
+	default:
+		return sbind, fmt.Errorf("unsupported batch type %T", first)
+	}
+
+	return sbind, nil
+}
+
+// dmlRowCounts returns the number of rows affected by each iteration of the last array DML execute.
+// The statement must have been executed with OCI_RETURN_ROW_COUNT_ARRAY.
+func (stmt *Stmt) dmlRowCounts(iters int) ([]int64, error) {
+	var rowCountArray *C.ub8
+	size, err := stmt.ociAttrGet(unsafe.Pointer(&rowCountArray), C.OCI_ATTR_DML_ROW_COUNT_ARRAY)
+	if err != nil {
+		return nil, err
+	}
+	if rowCountArray == nil {
+		return nil, nil
+	}
+
+	count := int(size)
+	if count > iters || count == 0 {
+		count = iters
+	}
+	rowCounts := make([]int64, count)
+	counts := (*[1 << 28]C.ub8)(unsafe.Pointer(rowCountArray))[:count:count]
+	for i := 0; i < count; i++ {
+		rowCounts[i] = int64(counts[i])
+	}
+
+	return rowCounts, nil
+}
+
+// LastInsertId is not supported for array DML
+func (result *BatchResult) LastInsertId() (int64, error) {
+	return 0, ErrNoRowid
+}
+
+// RowsAffected returns the total rows affected by all rows of the batch
+func (result *BatchResult) RowsAffected() (int64, error) {
+	return result.rowsAffected, nil
+}
+
+// RowCounts returns the rows affected by each row of the batch, in row order
+func (result *BatchResult) RowCounts() []int64 {
+	return result.rowCounts
+}
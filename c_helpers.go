@@ -73,12 +73,8 @@ func cGoStringN(s *C.OraText, size int) string {
 // freeDefines frees defines
 func freeDefines(defines []defineStruct) {
 	for i := 0; i < len(defines); i++ {
-		if len(defines[i].subDefines) > 0 {
-			freeDefines(defines[i].subDefines)
-		}
-		defines[i].subDefines = nil
 		if defines[i].pbuf != nil {
-			freeBuffer(defines[i].pbuf, defines[i].dataType)
+			freeBufferArray(defines[i].pbuf, defines[i].dataType, defines[i].arraySize)
 			defines[i].pbuf = nil
 		}
 		if defines[i].length != nil {
@@ -96,8 +92,32 @@ func freeDefines(defines []defineStruct) {
 // freeBinds frees binds
 func freeBinds(binds []bindStruct) {
 	for _, bind := range binds {
+		if bind.lobConn != nil && bind.pbuf != nil {
+			C.OCILobFreeTemporary(bind.lobConn.svc, bind.lobConn.errHandle, *(**C.OCILobLocator)(bind.pbuf))
+		}
+		if bind.stream != nil {
+			bind.stream.free()
+		}
+		if bind.pbuf != nil && bind.dateTimes != nil {
+			// pooled descriptors go back to the environment instead of OCIDescriptorFree
+			count := bind.arraySize
+			if count == 0 {
+				count = 1
+			}
+			pointers := (*[1 << 28]unsafe.Pointer)(bind.pbuf)[:count:count]
+			for i := 0; i < count; i++ {
+				bind.dateTimes.descriptorPut(C.OCI_DTYPE_TIMESTAMP_TZ, pointers[i])
+			}
+			C.free(bind.pbuf)
+			bind.pbuf = nil
+			bind.dateTimes = nil
+		}
 		if bind.pbuf != nil {
-			freeBuffer(bind.pbuf, bind.dataType)
+			if bind.arraySize > 0 {
+				freeBufferArray(bind.pbuf, bind.dataType, bind.arraySize)
+			} else {
+				freeBuffer(bind.pbuf, bind.dataType)
+			}
 			bind.pbuf = nil
 		}
 		if bind.length != nil {
@@ -128,9 +148,30 @@ func freeBuffer(buffer unsafe.Pointer, dataType C.ub2) {
 		C.OCIDescriptorFree(*(*unsafe.Pointer)(buffer), C.OCI_DTYPE_INTERVAL_DS)
 	case C.SQLT_INTERVAL_YM:
 		C.OCIDescriptorFree(*(*unsafe.Pointer)(buffer), C.OCI_DTYPE_INTERVAL_YM)
+	case C.SQLT_JSON:
+		C.OCIDescriptorFree(*(*unsafe.Pointer)(buffer), C.OCI_DTYPE_JSON)
 	case C.SQLT_RSET:
-		C.OCIDescriptorFree(*(*unsafe.Pointer)(buffer), C.OCI_HTYPE_STMT)
+		// a REF CURSOR is a statement handle, nil when given to rows from an out bind
+		if *(*unsafe.Pointer)(buffer) != nil {
+			C.OCIHandleFree(*(*unsafe.Pointer)(buffer), C.OCI_HTYPE_STMT)
+		}
 	default:
 		C.free(buffer)
 	}
 }
+
+// freeBufferArray frees an array buffer of count elements.
+// For descriptor data types each non nil descriptor is freed then the C pointer array is freed.
+func freeBufferArray(buffer unsafe.Pointer, dataType C.ub2, count int) {
+	switch dataType {
+	case C.SQLT_CLOB, C.SQLT_BLOB, C.SQLT_TIMESTAMP, C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ,
+		C.SQLT_INTERVAL_DS, C.SQLT_INTERVAL_YM, C.SQLT_RSET, C.SQLT_JSON:
+		pointers := (*[1 << 28]unsafe.Pointer)(buffer)[:count:count]
+		for i := 0; i < count; i++ {
+			if pointers[i] != nil {
+				freeBuffer(unsafe.Pointer(&pointers[i]), dataType)
+			}
+		}
+	}
+	C.free(buffer)
+}
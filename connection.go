@@ -9,6 +9,8 @@ import (
 	"database/sql/driver"
 	"errors"
 	"fmt"
+	"math"
+	"sync/atomic"
 	"time"
 	"unsafe"
 )
@@ -19,10 +21,9 @@ func (conn *Conn) Ping(ctx context.Context) error {
 		return ctx.Err()
 	}
 
-	done := make(chan struct{})
-	go conn.ociBreakDone(ctx, done)
+	armed := conn.watchCancel(ctx)
 	result := C.OCIPing(conn.svc, conn.errHandle, C.OCI_DEFAULT)
-	close(done)
+	conn.unwatchCancel(armed)
 
 	if result == C.OCI_SUCCESS || result == C.OCI_SUCCESS_WITH_INFO {
 		return nil
@@ -43,10 +44,44 @@ func (conn *Conn) Close() error {
 	if conn.closed {
 		return nil
 	}
+
+	// a watchCancel running on another goroutine, for example for a Queue or Subscription, must not arm a closed watcher
+	conn.cancelMutex.Lock()
 	conn.closed = true
+	if conn.cancelArm != nil {
+		close(conn.cancelArm)
+		conn.cancelArm = nil
+	}
+	conn.cancelMutex.Unlock()
+
+	if conn.endpoint != nil {
+		atomic.AddInt64(&conn.endpoint.inFlight, -1)
+	}
+
+	for cacheKey := range conn.defineCache {
+		conn.dropDefines(cacheKey)
+	}
 
 	var err error
-	if useOCISessionBegin {
+	if conn.sessionPool != nil {
+		// the service context belongs to the session pool, so unset the transaction handle before releasing the session
+		if rv := C.OCIAttrSet(
+			unsafe.Pointer(conn.svc),
+			C.OCI_HTYPE_SVCCTX,
+			nil,
+			0,
+			C.OCI_ATTR_TRANS,
+			conn.errHandle,
+		); rv != C.OCI_SUCCESS {
+			err = conn.getError(rv)
+		}
+		if conn.callTimeout != 0 {
+			conn.setCallTimeout(context.Background())
+		}
+		if rv := conn.sessionRelease(); rv != nil {
+			err = rv
+		}
+	} else if useOCISessionBegin {
 		if rv := C.OCISessionEnd(
 			conn.svc,
 			conn.errHandle,
@@ -75,10 +110,12 @@ func (conn *Conn) Close() error {
 		}
 	}
 
-	C.OCIHandleFree(unsafe.Pointer(conn.svc), C.OCI_HTYPE_SVCCTX)
-	C.OCIHandleFree(unsafe.Pointer(conn.errHandle), C.OCI_HTYPE_ERROR)
-	C.OCIHandleFree(unsafe.Pointer(conn.txHandle), C.OCI_HTYPE_TRANS)
-	C.OCIHandleFree(unsafe.Pointer(conn.env), C.OCI_HTYPE_ENV)
+	if conn.svc != nil {
+		C.OCIHandleFree(unsafe.Pointer(conn.svc), C.OCI_HTYPE_SVCCTX)
+	}
+	// the environment is shared, so error and transaction handles go back to its free lists
+	conn.environment.handlePut(C.OCI_HTYPE_ERROR, unsafe.Pointer(conn.errHandle))
+	conn.environment.handlePut(C.OCI_HTYPE_TRANS, unsafe.Pointer(conn.txHandle))
 	conn.svc = nil
 	conn.errHandle = nil
 	conn.txHandle = nil
@@ -107,9 +144,8 @@ func (conn *Conn) PrepareContext(ctx context.Context, query string) (driver.Stmt
 		return nil, ctx.Err()
 	}
 
-	done := make(chan struct{})
-	go conn.ociBreakDone(ctx, done)
-	defer func() { close(done) }()
+	armed := conn.watchCancel(ctx)
+	defer conn.unwatchCancel(armed)
 
 	if conn.stmtCacheSize == 0 {
 		if rv := C.OCIStmtPrepare2(
@@ -208,6 +244,7 @@ func (conn *Conn) getError(result C.sword) error {
 			ORA-12537: TNS:connection closed
 		*/
 		case 28, 1012, 1033, 1034, 1089, 3113, 3114, 3135, 12528, 12537:
+			conn.badConnection = true
 			return driver.ErrBadConn
 		}
 		return err
@@ -338,6 +375,64 @@ func (conn *Conn) ociDescriptorAlloc(descriptorType C.ub4, size C.size_t) (*unsa
 	return descriptor, nil, nil
 }
 
+// ociDescriptorAllocArray calls OCIDescriptorAlloc size times then returns
+// a C array of size descriptor pointers, that must be freed with freeBufferArray, and error
+func (conn *Conn) ociDescriptorAllocArray(descriptorType C.ub4, size int) (unsafe.Pointer, error) {
+	buffer := C.malloc(C.size_t(size) * C.size_t(sizeOfNilPointer))
+	pointers := (*[1 << 28]unsafe.Pointer)(buffer)[:size:size]
+	for i := range pointers {
+		pointers[i] = nil
+	}
+
+	for i := range pointers {
+		result := C.OCIDescriptorAlloc(
+			unsafe.Pointer(conn.env), // An environment handle
+			&pointers[i],             // Returns a descriptor or LOB locator of desired type
+			descriptorType,           // Specifies the type of descriptor or LOB locator to be allocated
+			0,                        // Specifies an amount of user memory to be allocated for use by the application for the lifetime of the descriptor
+			nil,                      // Returns a pointer to the user memory of size xtramem_sz allocated by the call for the user for the lifetime of the descriptor
+		)
+		if result != C.OCI_SUCCESS {
+			for j := 0; j < i; j++ {
+				C.OCIDescriptorFree(pointers[j], descriptorType)
+			}
+			C.free(buffer)
+			return nil, conn.getError(result)
+		}
+	}
+
+	return buffer, nil
+}
+
+// ociHandleAllocArray calls OCIHandleAlloc size times then returns
+// a C array of size handle pointers, that must be freed with freeBufferArray, and error
+func (conn *Conn) ociHandleAllocArray(handleType C.ub4, size int) (unsafe.Pointer, error) {
+	buffer := C.malloc(C.size_t(size) * C.size_t(sizeOfNilPointer))
+	pointers := (*[1 << 28]unsafe.Pointer)(buffer)[:size:size]
+	for i := range pointers {
+		pointers[i] = nil
+	}
+
+	for i := range pointers {
+		result := C.OCIHandleAlloc(
+			unsafe.Pointer(conn.env), // An environment handle
+			&pointers[i],             // Returns a handle
+			handleType,               // type of handle: https://docs.oracle.com/cd/B28359_01/appdev.111/b28395/oci02bas.htm#LNOCI87581
+			0,                        // amount of user memory to be allocated
+			nil,                      // Returns a pointer to the user memory
+		)
+		if result != C.OCI_SUCCESS {
+			for j := 0; j < i; j++ {
+				C.OCIHandleFree(pointers[j], handleType)
+			}
+			C.free(buffer)
+			return nil, conn.getError(result)
+		}
+	}
+
+	return buffer, nil
+}
+
 // ociLobCreateTemporary calls OCILobCreateTemporary then returns error
 func (conn *Conn) ociLobCreateTemporary(lobLocator *C.OCILobLocator, form C.ub1, lobType C.ub1) error {
 
@@ -370,9 +465,16 @@ func (conn *Conn) ociLobRead(lobLocator *C.OCILobLocator, form C.ub1) ([]byte, e
 		return buffer, conn.getError(result)
 	}
 
+	return conn.ociLobReadFrom(lobLocator, form, 1, buffer)
+}
+
+// ociLobReadFrom calls OCILobRead2 in polling mode to read the rest of the lob from the 1 based offset,
+// in bytes for BLOB and in characters for CLOB, then returns buffer with the bytes appended and error.
+func (conn *Conn) ociLobReadFrom(lobLocator *C.OCILobLocator, form C.ub1, offset int64, buffer []byte) ([]byte, error) {
 	readBuffer := byteBufferPool.Get().([]byte)
+	defer byteBufferPool.Put(readBuffer)
 	piece := (C.ub1)(C.OCI_FIRST_PIECE)
-	result = C.OCI_NEED_DATA
+	result := C.sword(C.OCI_NEED_DATA)
 
 	for result == C.OCI_NEED_DATA {
 		readBytes := (C.oraub8)(0)
@@ -384,7 +486,7 @@ func (conn *Conn) ociLobRead(lobLocator *C.OCILobLocator, form C.ub1) ([]byte, e
 			lobLocator,                     // LOB or BFILE locator
 			&readBytes,                     // number of bytes to read. Used for BLOB and BFILE always. For CLOB and NCLOB, it is used only when char_amtp is zero.
 			nil,                            // number of characters to read
-			1,                              // the offset in the first call and in subsequent polling calls the offset parameter is ignored
+			C.oraub8(offset),               // the offset in the first call and in subsequent polling calls the offset parameter is ignored
 			unsafe.Pointer(&readBuffer[0]), // pointer to a buffer into which the piece will be read
 			lobBufferSize,                  // length of the buffer
 			piece,                          // For polling, pass OCI_FIRST_PIECE the first time and OCI_NEXT_PIECE in subsequent calls.
@@ -403,6 +505,11 @@ func (conn *Conn) ociLobRead(lobLocator *C.OCILobLocator, form C.ub1) ([]byte, e
 		}
 	}
 
+	if result == C.OCI_NO_DATA && offset > 1 {
+		// the offset is past the end of the lob, nothing more to read
+		return buffer, nil
+	}
+
 	return buffer, conn.getError(result)
 }
 
@@ -410,6 +517,7 @@ func (conn *Conn) ociLobRead(lobLocator *C.OCILobLocator, form C.ub1) ([]byte, e
 func (conn *Conn) ociLobWrite(lobLocator *C.OCILobLocator, form C.ub1, data []byte) error {
 	start := 0
 	writeBuffer := byteBufferPool.Get().([]byte)
+	defer byteBufferPool.Put(writeBuffer)
 	piece := (C.ub1)(C.OCI_FIRST_PIECE)
 	writeBytes := (C.oraub8)(len(data))
 	if len(data) <= lobBufferSize {
@@ -460,79 +568,62 @@ func (conn *Conn) ociLobWrite(lobLocator *C.OCILobLocator, form C.ub1, data []by
 	return nil
 }
 
-// ociDateTimeToTime coverts OCIDateTime to Go Time
+// ociDateTimeToTime coverts OCIDateTime to Go Time.
+// A time zone region is kept as a named location, an offset is a cached fixed zone.
 func (conn *Conn) ociDateTimeToTime(dateTime *C.OCIDateTime, ociDateTimeHasTimeZone bool) (*time.Time, error) {
-	// get date
-	var year C.sb2
-	var month C.ub1
-	var day C.ub1
-	result := C.OCIDateTimeGetDate(
-		unsafe.Pointer(conn.env), // environment handle
-		conn.errHandle,           // error handle
-		dateTime,                 // pointer to an OCIDateTime
-		&year,                    // year
-		&month,                   // month
-		&day,                     // day
-	)
-	err := conn.getError(result)
-	if err != nil {
-		return nil, err
+	var withTimeZone C.int
+	if ociDateTimeHasTimeZone {
+		withTimeZone = 1
 	}
 
-	// get time
-	var hour C.ub1
-	var min C.ub1
-	var sec C.ub1
-	var fsec C.ub4
-	result = C.OCIDateTimeGetTime(
+	var fields C.ociDateTimeFields
+	result := C.ociDateTimeGetFields(
 		unsafe.Pointer(conn.env), // environment handle
 		conn.errHandle,           // error handle
 		dateTime,                 // pointer to an OCIDateTime
-		&hour,                    // hour
-		&min,                     // min
-		&sec,                     // sec
-		&fsec,                    // fsec
+		withTimeZone,             // also get the time zone offset and name
+		&fields,                  // returns the fields
 	)
-	err = conn.getError(result)
+	err := conn.getError(result)
 	if err != nil {
 		return nil, err
 	}
 
-	if !ociDateTimeHasTimeZone {
-		aTime := time.Date(int(year), time.Month(month), int(day), int(hour), int(min), int(sec), int(fsec), conn.timeLocation)
-		return &aTime, nil
-	}
+	aTime := conn.dateTimeFieldsToTime(&fields, ociDateTimeHasTimeZone)
+	return &aTime, nil
+}
 
-	// get OCI time zone offset
-	var timeZoneHour C.sb1
-	var timeZoneMin C.sb1
-	result = C.OCIDateTimeGetTimeZoneOffset(
-		unsafe.Pointer(conn.env), // environment handle
-		conn.errHandle,           // error handle
-		dateTime,                 // pointer to an OCIDateTime
-		&timeZoneHour,            // time zone hour
-		&timeZoneMin,             // time zone minute
-	)
-	err = conn.getError(result)
-	if err != nil {
-		return nil, err
+// dateTimeFieldsToTime converts the fields returned by ociDateTimeGetFields to Go Time
+func (conn *Conn) dateTimeFieldsToTime(fields *C.ociDateTimeFields, withTimeZone bool) time.Time {
+	if !withTimeZone {
+		return time.Date(int(fields.year), time.Month(fields.month), int(fields.day),
+			int(fields.hour), int(fields.minute), int(fields.second), int(fields.fsec), conn.timeLocation)
 	}
 
 	// return Go Time using OCI time zone offset
-	aTime := time.Date(int(year), time.Month(month), int(day), int(hour), int(min), int(sec), int(fsec),
-		timezoneToLocation(int64(timeZoneHour), int64(timeZoneMin)))
-	return &aTime, nil
+	aTime := time.Date(int(fields.year), time.Month(fields.month), int(fields.day),
+		int(fields.hour), int(fields.minute), int(fields.second), int(fields.fsec),
+		timezoneToLocation(int64(fields.timeZoneHour), int64(fields.timeZoneMinute)))
+
+	// the offset gives the instant, the region only the location, so daylight saving overlaps stay exact
+	if fields.timeZoneNameLength > 0 && fields.timeZoneName[0] != '+' && fields.timeZoneName[0] != '-' {
+		name := (*[64]byte)(unsafe.Pointer(&fields.timeZoneName[0]))[:fields.timeZoneNameLength]
+		location := regionToLocation(name)
+		if location != nil {
+			aTime = aTime.In(location)
+		}
+	}
+
+	return aTime
 }
 
-// timeToOCIDateTime coverts Go Time to OCIDateTime
-func (conn *Conn) timeToOCIDateTime(aTime *time.Time) (*unsafe.Pointer, error) {
-	var err error
-	var dateTimePP *unsafe.Pointer
-	dateTimePP, _, err = conn.ociDescriptorAlloc(C.OCI_DTYPE_TIMESTAMP_TZ, 0)
+// timeToPooledDateTime coverts Go Time to an OCIDateTime TIMESTAMP WITH TIME ZONE descriptor
+// taken from the descriptor pool of the environment, that must be returned with descriptorPut
+func (conn *Conn) timeToPooledDateTime(aTime *time.Time) (unsafe.Pointer, error) {
+	dateTimeP, err := conn.environment.descriptorGet(C.OCI_DTYPE_TIMESTAMP_TZ)
 	if err != nil {
 		return nil, err
 	}
-	dateTimeP := (*C.OCIDateTime)(*dateTimePP)
 
 	// make time zone string formated: [+|-][HH:MM]
 	_, offset := aTime.Zone()
@@ -551,25 +642,67 @@ func (conn *Conn) timeToOCIDateTime(aTime *time.Time) (*unsafe.Pointer, error) {
 	timeZone = appendSmallInt(timeZone, offset/60)
 
 	result := C.OCIDateTimeConstruct(
-		unsafe.Pointer(conn.env),   // environment handle
-		conn.errHandle,             // error handle
-		dateTimeP,                  // an OCIDateTime pointer
-		C.sb2(aTime.Year()),        // year
-		C.ub1(aTime.Month()),       // month
-		C.ub1(aTime.Day()),         // day
-		C.ub1(aTime.Hour()),        // hour
-		C.ub1(aTime.Minute()),      // minute
-		C.ub1(aTime.Second()),      // second
-		C.ub4(aTime.Nanosecond()),  // fractional second
-		(*C.OraText)(&timeZone[0]), // time zone string formated: [+|-][HH:MM]
-		C.size_t(6),                //  time zone string length
+		unsafe.Pointer(conn.env),    // environment handle
+		conn.errHandle,              // error handle
+		(*C.OCIDateTime)(dateTimeP), // an OCIDateTime pointer
+		C.sb2(aTime.Year()),         // year
+		C.ub1(aTime.Month()),        // month
+		C.ub1(aTime.Day()),          // day
+		C.ub1(aTime.Hour()),         // hour
+		C.ub1(aTime.Minute()),       // minute
+		C.ub1(aTime.Second()),       // second
+		C.ub4(aTime.Nanosecond()),   // fractional second
+		(*C.OraText)(&timeZone[0]),  // time zone string formated: [+|-][HH:MM]
+		C.size_t(6),                 //  time zone string length
 	)
 	err = conn.getError(result)
 	if err != nil {
+		conn.environment.descriptorPut(C.OCI_DTYPE_TIMESTAMP_TZ, dateTimeP)
 		return nil, err
 	}
 
-	return dateTimePP, nil
+	return dateTimeP, nil
+}
+
+// dateBindable returns true if aTime can be bound in the DATE format without losing anything but its time zone
+func (conn *Conn) dateBindable(aTime *time.Time) bool {
+	if !conn.dateBinds || aTime.Nanosecond() != 0 {
+		return false
+	}
+	year := aTime.In(conn.timeLocation).Year()
+	return year >= -4712 && year <= 9999 && year != 0
+}
+
+// encodeDate encodes aTime, in the time location of the connection, to the 7 byte DATE format in buffer:
+// century+100, year+100, month, day, hour+1, minute+1, second+1
+func (conn *Conn) encodeDate(buffer []byte, aTime *time.Time) {
+	localTime := aTime.In(conn.timeLocation)
+	year := localTime.Year()
+	buffer[0] = byte(year/100 + 100)
+	buffer[1] = byte(year%100 + 100)
+	buffer[2] = byte(localTime.Month())
+	buffer[3] = byte(localTime.Day())
+	buffer[4] = byte(localTime.Hour() + 1)
+	buffer[5] = byte(localTime.Minute() + 1)
+	buffer[6] = byte(localTime.Second() + 1)
+}
+
+// decodeDate decodes the 7 byte DATE format in buffer, the reverse of encodeDate, to a time in location.
+// BCE years are negative, same as the year returned by OCIDateTimeGetDate
+// (http://docs.oracle.com/cd/B12037_01/appdev.101/b10779/oci03typ.htm#438305)
+func decodeDate(buffer []byte, location *time.Location) (time.Time, error) {
+	if len(buffer) != 7 {
+		return time.Time{}, fmt.Errorf("invalid DATE length %v", len(buffer))
+	}
+	return time.Date(
+		(int(buffer[0])-100)*100+(int(buffer[1])-100),
+		time.Month(int(buffer[2])),
+		int(buffer[3]),
+		int(buffer[4])-1,
+		int(buffer[5])-1,
+		int(buffer[6])-1,
+		0,
+		location), nil
 }
 
 // appendSmallInt takes small int and returns an appended byte slice
@@ -584,20 +717,87 @@ func appendSmallInt(slice []byte, num int) []byte {
 	return append(slice, byte('0'+num/10), byte('0'+(num%10)))
 }
 
-// ociBreakDone calls OCIBreak if ctx.Done is finished before done chan is closed
-func (conn *Conn) ociBreakDone(ctx context.Context, done chan struct{}) {
-	select {
-	case <-done:
-	case <-ctx.Done():
-		// select again to avoid race condition if both are done
+// watchCancel arms the cancel watcher of the connection so OCIBreak is called if ctx is done before unwatchCancel.
+// The watcher goroutine is started once per connection and is not used when ctx can never be done.
+// When ctx has a deadline, it is also set as the OCI_ATTR_CALL_TIMEOUT of the service context.
+// Returns true if the watcher was armed.
+func (conn *Conn) watchCancel(ctx context.Context) bool {
+	conn.setCallTimeout(ctx)
+
+	if ctx.Done() == nil {
+		return false
+	}
+
+	conn.cancelMutex.Lock()
+	defer conn.cancelMutex.Unlock()
+	if conn.closed {
+		return false
+	}
+
+	if conn.cancelArm == nil {
+		conn.cancelArm = make(chan context.Context)
+		conn.cancelDisarm = make(chan struct{})
+		go conn.cancelWatcher(conn.cancelArm, conn.cancelDisarm)
+	}
+
+	conn.cancelArm <- ctx
+	return true
+}
+
+// unwatchCancel disarms the cancel watcher if armed is true.
+// When it returns the watcher will not call OCIBreak for the ctx it was armed with.
+func (conn *Conn) unwatchCancel(armed bool) {
+	if armed {
+		conn.cancelDisarm <- struct{}{}
+	}
+}
+
+// cancelWatcher calls OCIBreak if the ctx it is armed with is done before it is disarmed.
+// It runs until arm is closed by Close.
+func (conn *Conn) cancelWatcher(arm chan context.Context, disarm chan struct{}) {
+	for ctx := range arm {
 		select {
-		case <-done:
-		default:
+		case <-disarm:
+		case <-ctx.Done():
 			conn.ociBreak()
+			<-disarm
 		}
 	}
 }
 
+// setCallTimeout sets OCI_ATTR_CALL_TIMEOUT to the time left until the ctx deadline so the server side call is timed out too.
+// The time left is computed for every call, the attribute is only set when it differs from the value last set.
+func (conn *Conn) setCallTimeout(ctx context.Context) {
+	deadline, ok := ctx.Deadline()
+	callTimeout := callTimeoutFor(deadline, ok, time.Now())
+	if callTimeout == conn.callTimeout {
+		return
+	}
+
+	err := conn.ociAttrSet(unsafe.Pointer(conn.svc), C.OCI_HTYPE_SVCCTX, unsafe.Pointer(&callTimeout), 0, C.OCI_ATTR_CALL_TIMEOUT)
+	if err != nil {
+		conn.logger.Print("call timeout attribute set error: ", err)
+		return
+	}
+	conn.callTimeout = callTimeout
+}
+
+// callTimeoutFor returns the OCI_ATTR_CALL_TIMEOUT milliseconds left at now until deadline, 0 for no deadline.
+// Deadlines further than the ub4 max of about 49.7 days are clamped to it.
+func callTimeoutFor(deadline time.Time, ok bool, now time.Time) C.ub4 {
+	if !ok {
+		return 0
+	}
+	milliseconds := deadline.Sub(now) / time.Millisecond
+	if milliseconds < 1 {
+		return 1
+	}
+	if milliseconds > math.MaxUint32 {
+		return math.MaxUint32
+	}
+	return C.ub4(milliseconds)
+}
+
 // ociBreak calls OCIBreak
 func (conn *Conn) ociBreak() {
 	result := C.OCIBreak(
@@ -6,15 +6,58 @@ package gobci
 import (
 	"context"
 	"database/sql/driver"
+	"errors"
 	"io/ioutil"
 	"log"
+	"sync/atomic"
+	"time"
 )
 
-// NewConnector returns a new database connector
-func NewConnector(hosts ...string) driver.Connector {
-	return &Connector{
-		Logger: log.New(ioutil.Discard, "", 0),
+const (
+	defaultEndpointCooldown = 30 * time.Second
+)
+
+// NewConnector returns a new database connector.
+// The DSN is parsed once and reused for every new connection.
+//
+// When endpoints are given, each one is a connect string (host[:port][/service_name]) that replaces the host part of the DSN,
+// for example the addresses of several OBProxy instances. Each new connection goes to the endpoint with the least
+// in-flight connections, ties broken by the lowest observed connect latency. An endpoint that fails to connect
+// is taken out of rotation for Cooldown and the next endpoint is tried.
+func NewConnector(dsnString string, endpoints ...string) (*Connector, error) {
+	dsn, err := ParseDSN(dsnString)
+	if err != nil {
+		return nil, err
 	}
+
+	if len(endpoints) == 0 {
+		endpoints = []string{dsn.Connect}
+	}
+
+	connector := &Connector{
+		Logger:    log.New(ioutil.Discard, "", 0),
+		Cooldown:  defaultEndpointCooldown,
+		dsn:       dsn,
+		endpoints: make([]*endpointStruct, len(endpoints)),
+	}
+	for i := 0; i < len(endpoints); i++ {
+		connector.endpoints[i] = &endpointStruct{connect: endpoints[i]}
+	}
+
+	return connector, nil
+}
+
+// OpenConnector implements driver.DriverContext so the DSN is only parsed once by sql.Open
+func (drv *DriverStruct) OpenConnector(dsnString string) (driver.Connector, error) {
+	connector, err := NewConnector(dsnString)
+	if err != nil {
+		return nil, err
+	}
+	if drv.Logger != nil {
+		connector.Logger = drv.Logger
+	}
+
+	return connector, nil
 }
 
 // Driver returns the OCI8 driver
@@ -24,16 +67,103 @@ func (connector *Connector) Driver() driver.Driver {
 
 // Connect returns a new database connection
 func (connector *Connector) Connect(ctx context.Context) (driver.Conn, error) {
-	if ctx.Err() != nil {
-		return nil, ctx.Err()
+	if connector.dsn == nil {
+		return nil, errors.New("connector has no dsn, use NewConnector")
+	}
+
+	logger := connector.Logger
+	if logger == nil {
+		logger = log.New(ioutil.Discard, "", 0)
+	}
+
+	var err error
+	tried := make(map[*endpointStruct]bool, len(connector.endpoints))
+	for len(tried) < len(connector.endpoints) {
+		if ctx.Err() != nil {
+			return nil, ctx.Err()
+		}
+
+		endpoint := connector.pickEndpoint(tried)
+		tried[endpoint] = true
+
+		dsn := *connector.dsn
+		dsn.Connect = endpoint.connect
+
+		atomic.AddInt64(&endpoint.inFlight, 1)
+		start := time.Now()
+		var conn *Conn
+		conn, err = openConn(&dsn, logger)
+		if err != nil {
+			atomic.AddInt64(&endpoint.inFlight, -1)
+			connector.endpointFailed(endpoint)
+			logger.Printf("connect to %v error: %v", endpoint.connect, err)
+			continue
+		}
+		connector.endpointConnected(endpoint, time.Since(start))
+		conn.endpoint = endpoint
+
+		return conn, nil
 	}
 
-	conn := &Conn{
-		logger: connector.Logger,
+	return nil, err
+}
+
+// pickEndpoint returns the endpoint not in tried that is not cooling down, with the least in-flight connections,
+// then the lowest connect latency. If all are cooling down, returns the one whose cooldown ends first.
+func (connector *Connector) pickEndpoint(tried map[*endpointStruct]bool) *endpointStruct {
+	connector.mutex.Lock()
+	defer connector.mutex.Unlock()
+
+	now := time.Now()
+	var best *endpointStruct
+	var bestInFlight int64
+	var coolest *endpointStruct
+
+	for _, endpoint := range connector.endpoints {
+		if tried[endpoint] {
+			continue
+		}
+
+		if now.Before(endpoint.cooldownUntil) {
+			if coolest == nil || endpoint.cooldownUntil.Before(coolest.cooldownUntil) {
+				coolest = endpoint
+			}
+			continue
+		}
+
+		inFlight := atomic.LoadInt64(&endpoint.inFlight)
+		if best == nil || inFlight < bestInFlight || (inFlight == bestInFlight && endpoint.latency < best.latency) {
+			best = endpoint
+			bestInFlight = inFlight
+		}
+	}
+
+	if best == nil {
+		return coolest
+	}
+	return best
+}
+
+// endpointConnected updates the connect latency moving average of endpoint and puts it back in rotation
+func (connector *Connector) endpointConnected(endpoint *endpointStruct, latency time.Duration) {
+	connector.mutex.Lock()
+	if endpoint.latency == 0 {
+		endpoint.latency = latency
+	} else {
+		endpoint.latency = (endpoint.latency*7 + latency) / 8
 	}
-	if conn.logger == nil {
-		conn.logger = log.New(ioutil.Discard, "", 0)
+	endpoint.cooldownUntil = time.Time{}
+	connector.mutex.Unlock()
+}
+
+// endpointFailed takes endpoint out of rotation for the cooldown
+func (connector *Connector) endpointFailed(endpoint *endpointStruct) {
+	cooldown := connector.Cooldown
+	if cooldown <= 0 {
+		cooldown = defaultEndpointCooldown
 	}
 
-	return conn, nil
+	connector.mutex.Lock()
+	endpoint.cooldownUntil = time.Now().Add(cooldown)
+	connector.mutex.Unlock()
 }
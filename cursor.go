@@ -0,0 +1,100 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"context"
+	"unsafe"
+)
+
+// cursorRows returns rows reading the executed REF CURSOR or implicit result statement handle,
+// defined for fetching with the fetch array size and prefetch of ctx
+func (conn *Conn) cursorRows(handle *C.OCIStmt, ctx context.Context) (*Rows, error) {
+	rows := &Rows{}
+	err := conn.defineCursor(rows, handle, ctx)
+	if err != nil {
+		return nil, err
+	}
+	return rows, nil
+}
+
+// defineCursor sets rows to read the executed statement handle.
+// Without prefetch the handle fetches one row per round trip, so the prefetch of ctx is applied to it.
+func (conn *Conn) defineCursor(rows *Rows, handle *C.OCIStmt, ctx context.Context) error {
+	cursorStmt := &Stmt{conn: conn, stmt: handle, ctx: ctx, releaseMode: C.ub4(C.OCI_DEFAULT)}
+
+	defines, err := cursorStmt.makeDefines(conn.fetchArraySizeFor(ctx))
+	if err != nil {
+		return err
+	}
+
+	prefetch := conn.prefetchFor(ctx)
+	if prefetch.budget > 0 {
+		prefetch = prefetchStruct{rows: prefetchRowsFor(prefetch.budget, defines, 0)}
+	}
+	err = cursorStmt.setPrefetch(prefetch.rows, prefetch.memory)
+	if err != nil {
+		freeDefines(defines)
+		return err
+	}
+
+	rows.init(cursorStmt, defines)
+	return nil
+}
+
+// newCursorRows returns rows reading the REF CURSOR handle at cursor in a define buffer of rows.
+// The cursor rows are closed with rows or before rows fetch again into the define buffer.
+func (rows *Rows) newCursorRows(cursor *unsafe.Pointer) (*Rows, error) {
+	cursorRows, err := rows.stmt.conn.cursorRows((*C.OCIStmt)(*cursor), rows.stmt.ctx)
+	if err != nil {
+		return nil, err
+	}
+
+	cursorRows.parent = rows
+	cursorRows.cursor = cursor
+	if rows.cursors == nil {
+		rows.cursors = make(map[*Rows]struct{})
+	}
+	rows.cursors[cursorRows] = struct{}{}
+
+	return cursorRows, nil
+}
+
+// closeCursors closes the open REF CURSOR rows read from the define buffers of rows
+func (rows *Rows) closeCursors() {
+	for cursorRows := range rows.cursors {
+		cursorRows.Close()
+	}
+}
+
+// releaseCursor frees the REF CURSOR statement handle of closed rows so the server cursor is closed now,
+// not when the handle is fetched into again or the parent rows close.
+// A handle in a define buffer is replaced by a new handle for the next fetch of the parent rows.
+func (rows *Rows) releaseCursor() {
+	if rows.parent != nil {
+		delete(rows.parent.cursors, rows)
+		if !rows.parent.closed {
+			// a closed parent frees its define buffers and the handles in them
+			var handle unsafe.Pointer
+			result := C.OCIHandleAlloc(
+				unsafe.Pointer(rows.stmt.conn.env), // An environment handle
+				&handle,                            // Returns a handle
+				C.OCI_HTYPE_STMT,                   // type of handle: https://docs.oracle.com/cd/B28359_01/appdev.111/b28395/oci02bas.htm#LNOCI87581
+				0,                                  // amount of user memory to be allocated
+				nil,                                // Returns a pointer to the user memory
+			)
+			if result == C.OCI_SUCCESS {
+				C.OCIHandleFree(*rows.cursor, C.OCI_HTYPE_STMT)
+				*rows.cursor = handle
+			}
+		}
+		rows.parent = nil
+		rows.cursor = nil
+	}
+
+	if rows.ownsStmt {
+		C.OCIHandleFree(unsafe.Pointer(rows.stmt.stmt), C.OCI_HTYPE_STMT)
+		rows.ownsStmt = false
+	}
+}
@@ -0,0 +1,130 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"unsafe"
+)
+
+// getDefines returns, when available with the same fetch array size, the define buffers of the last closed rows
+// of cacheKey. The buffers are taken from the cache until returned by putDefines.
+// columns are the columns just described: when a column changed since the buffers were kept, for example
+// a VARCHAR2 widened by DDL, the kept buffers are dropped and columns are kept instead.
+func (conn *Conn) getDefines(cacheKey string, columns []defineStruct, fetchArraySize int) []defineStruct {
+	defineCache, ok := conn.defineCache[cacheKey]
+	if !ok || !sameColumns(defineCache.columns, columns) {
+		conn.dropDefines(cacheKey)
+		conn.putColumns(cacheKey, columns)
+		return nil
+	}
+
+	defines := defineCache.defines
+	defineCache.defines = nil
+	if len(defines) > 0 && defines[0].arraySize != fetchArraySize {
+		freeDefines(defines)
+		defines = nil
+	}
+
+	return defines
+}
+
+// sameColumns returns true if the columns have the same names, define data types, and buffer sizes
+func sameColumns(columns1 []defineStruct, columns2 []defineStruct) bool {
+	if len(columns1) != len(columns2) {
+		return false
+	}
+	for i := 0; i < len(columns1); i++ {
+		if columns1[i].name != columns2[i].name || columns1[i].dataType != columns2[i].dataType || columns1[i].maxSize != columns2[i].maxSize {
+			return false
+		}
+	}
+	return true
+}
+
+// putColumns keeps the described columns of a cached statement.
+// The number of kept statements is limited to the statement cache size.
+func (conn *Conn) putColumns(cacheKey string, columns []defineStruct) {
+	if conn.defineCache == nil {
+		conn.defineCache = make(map[string]*defineCacheStruct)
+	}
+
+	if _, ok := conn.defineCache[cacheKey]; !ok && len(conn.defineCache) >= int(conn.stmtCacheSize) {
+		// drop any one, the OCI statement cache has likely already aged it out
+		for key := range conn.defineCache {
+			conn.dropDefines(key)
+			break
+		}
+	}
+
+	conn.defineCache[cacheKey] = &defineCacheStruct{columns: columns}
+}
+
+// putDefines keeps the define buffers of closed rows for the next run of the cached statement.
+// Returns false if the buffers were not kept and need to be freed by the caller.
+// Buffers with ref cursor handles are never kept because the handles are given out as rows.
+func (conn *Conn) putDefines(cacheKey string, defines []defineStruct) bool {
+	defineCache, ok := conn.defineCache[cacheKey]
+	if !ok || defineCache.defines != nil || len(defineCache.columns) != len(defines) {
+		return false
+	}
+
+	for i := 0; i < len(defines); i++ {
+		if defines[i].dataType == C.SQLT_RSET || defines[i].dataType != defineCache.columns[i].dataType {
+			return false
+		}
+	}
+
+	for i := 0; i < len(defines); i++ {
+		defines[i].defineHandle = nil // freed by oci statement close, defined again on next run
+	}
+	defineCache.defines = defines
+
+	return true
+}
+
+// dropDefines frees the define buffers kept for cacheKey and forgets its described columns
+func (conn *Conn) dropDefines(cacheKey string) {
+	defineCache, ok := conn.defineCache[cacheKey]
+	if !ok {
+		return
+	}
+
+	freeDefines(defineCache.defines)
+	delete(conn.defineCache, cacheKey)
+}
+
+// allocDefine allocates the buffers of define for fetchArraySize rows, based on the define data type and buffer size
+func (conn *Conn) allocDefine(define *defineStruct, fetchArraySize int) error {
+	define.arraySize = fetchArraySize
+	define.length = (*C.ub2)(C.malloc(C.size_t(fetchArraySize) * C.sizeof_ub2))
+	define.indicator = (*C.sb2)(C.malloc(C.size_t(fetchArraySize) * C.sizeof_sb2))
+	lengths := (*[1 << 28]C.ub2)(unsafe.Pointer(define.length))[:fetchArraySize:fetchArraySize]
+	indicators := (*[1 << 28]C.sb2)(unsafe.Pointer(define.indicator))[:fetchArraySize:fetchArraySize]
+	for j := 0; j < fetchArraySize; j++ {
+		lengths[j] = 0
+		indicators[j] = 0
+	}
+
+	var err error
+	switch define.dataType {
+	case C.SQLT_CLOB, C.SQLT_BLOB:
+		define.pbuf, err = conn.ociDescriptorAllocArray(C.OCI_DTYPE_LOB, fetchArraySize)
+	case C.SQLT_TIMESTAMP:
+		define.pbuf, err = conn.ociDescriptorAllocArray(C.OCI_DTYPE_TIMESTAMP, fetchArraySize)
+	case C.SQLT_TIMESTAMP_TZ:
+		define.pbuf, err = conn.ociDescriptorAllocArray(C.OCI_DTYPE_TIMESTAMP_TZ, fetchArraySize)
+	case C.SQLT_INTERVAL_DS:
+		define.pbuf, err = conn.ociDescriptorAllocArray(C.OCI_DTYPE_INTERVAL_DS, fetchArraySize)
+	case C.SQLT_INTERVAL_YM:
+		define.pbuf, err = conn.ociDescriptorAllocArray(C.OCI_DTYPE_INTERVAL_YM, fetchArraySize)
+	case C.SQLT_RSET:
+		define.pbuf, err = conn.ociHandleAllocArray(C.OCI_HTYPE_STMT, fetchArraySize)
+	case C.SQLT_JSON:
+		define.pbuf, err = conn.ociDescriptorAllocArray(C.OCI_DTYPE_JSON, fetchArraySize)
+	default:
+		define.pbuf = C.malloc(C.size_t(define.maxSize) * C.size_t(fetchArraySize))
+	}
+
+	return err
+}
@@ -0,0 +1,749 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"context"
+	"database/sql/driver"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"strconv"
+	"strings"
+	"time"
+	"unsafe"
+)
+
+const (
+	// bulkLoadDateFormat is the date format of the load, time.Time values are formatted with bulkLoadTimeLayout
+	bulkLoadDateFormat = "YYYY-MM-DD HH24:MI:SS"
+	bulkLoadTimeLayout = "2006-01-02 15:04:05"
+	// bulkLoadTimestampFormat is the date format of TIMESTAMP and TIMESTAMP WITH LOCAL TIME ZONE columns
+	bulkLoadTimestampFormat = "YYYY-MM-DD HH24:MI:SS.FF9"
+	bulkLoadTimestampLayout = "2006-01-02 15:04:05.000000000"
+	// bulkLoadTimestampTZFormat is the date format of TIMESTAMP WITH TIME ZONE columns, the offset of the value is kept
+	bulkLoadTimestampTZFormat = "YYYY-MM-DD HH24:MI:SS.FF9 TZH:TZM"
+	bulkLoadTimestampTZLayout = "2006-01-02 15:04:05.000000000 -07:00"
+	// maxBulkLoadErrors is the number of rejected row errors kept in BulkLoadStats
+	maxBulkLoadErrors = 100
+)
+
+// NewBulkLoader opens a direct path load of columns of table.
+// Table and column names are used as stored in the data dictionary, usually upper case.
+// Values are sent as text and converted by the server: numbers as decimal strings,
+// time.Time values in the time location of the connection with the YYYY-MM-DD HH24:MI:SS date format,
+// with nanoseconds for TIMESTAMP columns and with their own offset for TIMESTAMP WITH TIME ZONE columns,
+// []byte as hex text for RAW columns and as is for other columns.
+// The loaded rows are visible after Finish, Abort discards them.
+// To get the driver Conn from a sql.Conn use sql.Conn.Raw
+func (conn *Conn) NewBulkLoader(ctx context.Context, table string, columns []string, options *BulkLoaderOptions) (*BulkLoader, error) {
+	if len(columns) == 0 {
+		return nil, errors.New("bulk loader needs at least one column")
+	}
+	if len(columns) > 0xffff {
+		return nil, fmt.Errorf("bulk loader has %v columns, max %v", len(columns), 0xffff)
+	}
+	if options == nil {
+		options = &BulkLoaderOptions{}
+	}
+	maxColumnSize := options.MaxColumnSize
+	if maxColumnSize < 1 {
+		maxColumnSize = 4000
+	}
+
+	loader := &BulkLoader{
+		conn:        conn,
+		ctx:         ctx,
+		columnCount: len(columns),
+		start:       time.Now(),
+	}
+
+	handle, _, err := conn.ociHandleAlloc(C.OCI_HTYPE_DIRPATH_CTX, 0)
+	if err != nil {
+		return nil, fmt.Errorf("allocate direct path context handle error: %v", err)
+	}
+	loader.dpctx = (*C.OCIDirPathCtx)(*handle)
+
+	err = loader.setContextAttributes(table, len(columns), options)
+	if err == nil {
+		err = loader.describeColumns(table, options.Schema, columns)
+	}
+	if err == nil {
+		err = loader.setColumns(columns, maxColumnSize)
+	}
+	if err != nil {
+		loader.free()
+		return nil, err
+	}
+
+	armed := conn.watchCancel(ctx)
+	result := C.OCIDirPathPrepare(
+		loader.dpctx,   // direct path context
+		conn.svc,       // service context
+		conn.errHandle, // error handle
+	)
+	conn.unwatchCancel(armed)
+	err = conn.getError(result)
+	if err != nil {
+		loader.free()
+		return nil, fmt.Errorf("direct path prepare error: %v", err)
+	}
+
+	// column array and stream handles are children of the prepared direct path context
+	var columnArray unsafe.Pointer
+	result = C.OCIHandleAlloc(
+		unsafe.Pointer(loader.dpctx),     // direct path context is the parent handle
+		&columnArray,                     // Returns a handle
+		C.OCI_HTYPE_DIRPATH_COLUMN_ARRAY, // type of handle
+		0,                                // amount of user memory to be allocated
+		nil,                              // Returns a pointer to the user memory
+	)
+	if result != C.OCI_SUCCESS {
+		loader.abort()
+		return nil, errors.New("allocate direct path column array handle error")
+	}
+	loader.columnArray = (*C.OCIDirPathColArray)(columnArray)
+
+	var stream unsafe.Pointer
+	result = C.OCIHandleAlloc(
+		unsafe.Pointer(loader.dpctx), // direct path context is the parent handle
+		&stream,                      // Returns a handle
+		C.OCI_HTYPE_DIRPATH_STREAM,   // type of handle
+		0,                            // amount of user memory to be allocated
+		nil,                          // Returns a pointer to the user memory
+	)
+	if result != C.OCI_SUCCESS {
+		loader.abort()
+		return nil, errors.New("allocate direct path stream handle error")
+	}
+	loader.stream = (*C.OCIDirPathStream)(stream)
+
+	// the number of rows the column array holds is decided by OCI from the buffer size and columns
+	var numRows C.ub4
+	result = C.OCIAttrGet(
+		columnArray,                      // Pointer to a handle type
+		C.OCI_HTYPE_DIRPATH_COLUMN_ARRAY, // The handle type
+		unsafe.Pointer(&numRows),         // Pointer to the storage for an attribute value
+		nil,                              // The size of the attribute value
+		C.OCI_ATTR_NUM_ROWS,              // The attribute type
+		conn.errHandle,                   // An error handle
+	)
+	err = conn.getError(result)
+	if err != nil {
+		loader.abort()
+		return nil, fmt.Errorf("direct path column array rows error: %v", err)
+	}
+	loader.maxRows = int(numRows)
+	if loader.maxRows < 1 {
+		loader.maxRows = 1
+	}
+
+	cells := C.size_t(loader.maxRows * loader.columnCount)
+	loader.cValues = C.malloc(cells * C.size_t(sizeOfNilPointer))
+	loader.cLengths = C.malloc(cells * C.sizeof_ub4)
+	loader.cFlags = C.malloc(cells)
+	loader.lengths = make([]int32, 0, loader.maxRows*loader.columnCount)
+
+	return loader, nil
+}
+
+// setContextAttributes sets the table and load options of the direct path context
+func (loader *BulkLoader) setContextAttributes(table string, columnCount int, options *BulkLoaderOptions) error {
+	conn := loader.conn
+	handle := unsafe.Pointer(loader.dpctx)
+
+	err := loader.setStringAttribute(handle, C.OCI_HTYPE_DIRPATH_CTX, table, C.OCI_ATTR_NAME)
+	if err != nil {
+		return fmt.Errorf("direct path table name error: %v", err)
+	}
+	if options.Schema != "" {
+		err = loader.setStringAttribute(handle, C.OCI_HTYPE_DIRPATH_CTX, options.Schema, C.OCI_ATTR_SCHEMA_NAME)
+		if err != nil {
+			return fmt.Errorf("direct path schema name error: %v", err)
+		}
+	}
+	if options.Partition != "" {
+		err = loader.setStringAttribute(handle, C.OCI_HTYPE_DIRPATH_CTX, options.Partition, C.OCI_ATTR_SUB_NAME)
+		if err != nil {
+			return fmt.Errorf("direct path partition name error: %v", err)
+		}
+	}
+	err = loader.setStringAttribute(handle, C.OCI_HTYPE_DIRPATH_CTX, bulkLoadDateFormat, C.OCI_ATTR_DATEFORMAT)
+	if err != nil {
+		return fmt.Errorf("direct path date format error: %v", err)
+	}
+
+	numCols := C.ub2(columnCount)
+	err = conn.ociAttrSet(handle, C.OCI_HTYPE_DIRPATH_CTX, unsafe.Pointer(&numCols), 0, C.OCI_ATTR_NUM_COLS)
+	if err != nil {
+		return fmt.Errorf("direct path number of columns error: %v", err)
+	}
+
+	if options.BufferSize > 0 {
+		bufferSize := C.ub4(options.BufferSize)
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_DIRPATH_CTX, unsafe.Pointer(&bufferSize), 0, C.OCI_ATTR_BUF_SIZE)
+		if err != nil {
+			return fmt.Errorf("direct path buffer size error: %v", err)
+		}
+	}
+
+	if options.Parallel {
+		parallel := C.ub1(1)
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_DIRPATH_CTX, unsafe.Pointer(&parallel), 0, C.OCI_ATTR_DIRPATH_PARALLEL)
+		if err != nil {
+			return fmt.Errorf("direct path parallel error: %v", err)
+		}
+	}
+
+	if options.NoLogging {
+		noLogging := C.ub1(1)
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_DIRPATH_CTX, unsafe.Pointer(&noLogging), 0, C.OCI_ATTR_DIRPATH_NOLOG)
+		if err != nil {
+			return fmt.Errorf("direct path no logging error: %v", err)
+		}
+	}
+
+	return nil
+}
+
+// describeColumns describes table and sets the data type of each loaded column in columnTypes.
+// Columns that are not found are left 0 and loaded as character data.
+func (loader *BulkLoader) describeColumns(table string, schema string, columns []string) error {
+	conn := loader.conn
+	name := table
+	if schema != "" {
+		name = schema + "." + table
+	}
+
+	handle, _, err := conn.ociHandleAlloc(C.OCI_HTYPE_DESCRIBE, 0)
+	if err != nil {
+		return fmt.Errorf("allocate describe handle error: %v", err)
+	}
+	defer C.OCIHandleFree(*handle, C.OCI_HTYPE_DESCRIBE)
+
+	cName := cString(name)
+	defer C.free(unsafe.Pointer(cName))
+	armed := conn.watchCancel(loader.ctx)
+	result := C.OCIDescribeAny(
+		conn.svc,                  // service context
+		conn.errHandle,            // error handle
+		unsafe.Pointer(cName),     // name of the object to describe
+		C.ub4(len(name)),          // length of the name
+		C.OCI_OTYPE_NAME,          // the object is given by name
+		C.OCI_DEFAULT,             // get the current version of the object
+		C.OCI_PTYPE_TABLE,         // the object is a table
+		(*C.OCIDescribe)(*handle), // describe handle
+	)
+	conn.unwatchCancel(armed)
+	err = conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("describe table %v error: %v", name, err)
+	}
+
+	// parameter descriptors of a describe handle are freed with it
+	var tableParam *C.OCIParam
+	result = C.OCIAttrGet(
+		*handle,                     // Pointer to a handle type
+		C.OCI_HTYPE_DESCRIBE,        // The handle type
+		unsafe.Pointer(&tableParam), // Pointer to the storage for an attribute value
+		nil,                         // The size of the attribute value
+		C.OCI_ATTR_PARAM,            // The attribute type
+		conn.errHandle,              // An error handle
+	)
+	err = conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("describe table %v error: %v", name, err)
+	}
+	var columnCount C.ub2
+	_, err = conn.ociAttrGet(tableParam, unsafe.Pointer(&columnCount), C.OCI_ATTR_NUM_COLS)
+	if err != nil {
+		return fmt.Errorf("describe table %v columns error: %v", name, err)
+	}
+	var columnList *C.OCIParam
+	_, err = conn.ociAttrGet(tableParam, unsafe.Pointer(&columnList), C.OCI_ATTR_LIST_COLUMNS)
+	if err != nil {
+		return fmt.Errorf("describe table %v columns error: %v", name, err)
+	}
+
+	types := make(map[string]C.ub2, int(columnCount))
+	for i := 1; i <= int(columnCount); i++ {
+		var column unsafe.Pointer
+		result = C.OCIParamGet(
+			unsafe.Pointer(columnList), // column list parameter
+			C.OCI_DTYPE_PARAM,          // handle type of the column list
+			conn.errHandle,             // error handle
+			&column,                    // returns the column parameter descriptor
+			C.ub4(i),                   // position of the column, 1 based
+		)
+		err = conn.getError(result)
+		if err != nil {
+			return fmt.Errorf("describe table %v column %v error: %v", name, i, err)
+		}
+		var dataType C.ub2
+		_, err = conn.ociAttrGet((*C.OCIParam)(column), unsafe.Pointer(&dataType), C.OCI_ATTR_DATA_TYPE)
+		if err != nil {
+			return fmt.Errorf("describe table %v column %v error: %v", name, i, err)
+		}
+		var columnName *C.OraText
+		size, err := conn.ociAttrGet((*C.OCIParam)(column), unsafe.Pointer(&columnName), C.OCI_ATTR_NAME)
+		if err != nil {
+			return fmt.Errorf("describe table %v column %v error: %v", name, i, err)
+		}
+		types[cGoStringN(columnName, int(size))] = dataType
+	}
+
+	loader.columnTypes = make([]C.ub2, len(columns))
+	for i := 0; i < len(columns); i++ {
+		dataType, ok := types[columns[i]]
+		if !ok {
+			// unquoted names are stored in upper case
+			dataType = types[strings.ToUpper(columns[i])]
+		}
+		loader.columnTypes[i] = dataType
+	}
+
+	return nil
+}
+
+// setColumns describes the loaded columns in the column list of the direct path context.
+// All columns are loaded from character data of at most maxColumnSize bytes.
+// TIMESTAMP columns get a date format with fractional seconds, and a time zone offset for TIMESTAMP WITH TIME ZONE.
+func (loader *BulkLoader) setColumns(columns []string, maxColumnSize int) error {
+	conn := loader.conn
+
+	var columnList *C.OCIParam
+	result := C.OCIAttrGet(
+		unsafe.Pointer(loader.dpctx), // Pointer to a handle type
+		C.OCI_HTYPE_DIRPATH_CTX,      // The handle type
+		unsafe.Pointer(&columnList),  // Pointer to the storage for an attribute value
+		nil,                          // The size of the attribute value
+		C.OCI_ATTR_LIST_COLUMNS,      // The attribute type
+		conn.errHandle,               // An error handle
+	)
+	err := conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("direct path column list error: %v", err)
+	}
+
+	for i := 0; i < len(columns); i++ {
+		var column unsafe.Pointer
+		result = C.OCIParamGet(
+			unsafe.Pointer(columnList), // column list parameter
+			C.OCI_DTYPE_PARAM,          // handle type of the column list
+			conn.errHandle,             // error handle
+			&column,                    // returns the column parameter descriptor
+			C.ub4(i+1),                 // position of the column, 1 based
+		)
+		err = conn.getError(result)
+		if err != nil {
+			return fmt.Errorf("direct path column %v error: %v", columns[i], err)
+		}
+
+		err = loader.setStringAttribute(column, C.OCI_DTYPE_PARAM, columns[i], C.OCI_ATTR_NAME)
+		if err == nil {
+			dataType := C.ub2(C.SQLT_CHR)
+			err = conn.ociAttrSet(column, C.OCI_DTYPE_PARAM, unsafe.Pointer(&dataType), 0, C.OCI_ATTR_DATA_TYPE)
+		}
+		if err == nil {
+			dataSize := C.ub4(maxColumnSize)
+			err = conn.ociAttrSet(column, C.OCI_DTYPE_PARAM, unsafe.Pointer(&dataSize), 0, C.OCI_ATTR_DATA_SIZE)
+		}
+		if err == nil {
+			switch loader.columnTypes[i] {
+			case C.SQLT_TIMESTAMP, C.SQLT_TIMESTAMP_LTZ:
+				err = loader.setStringAttribute(column, C.OCI_DTYPE_PARAM, bulkLoadTimestampFormat, C.OCI_ATTR_DATEFORMAT)
+			case C.SQLT_TIMESTAMP_TZ:
+				err = loader.setStringAttribute(column, C.OCI_DTYPE_PARAM, bulkLoadTimestampTZFormat, C.OCI_ATTR_DATEFORMAT)
+			}
+		}
+		C.OCIDescriptorFree(column, C.OCI_DTYPE_PARAM)
+		if err != nil {
+			return fmt.Errorf("direct path column %v error: %v", columns[i], err)
+		}
+	}
+
+	return nil
+}
+
+// setStringAttribute sets a text attribute of a handle
+func (loader *BulkLoader) setStringAttribute(handle unsafe.Pointer, handleType C.ub4, value string, attributeType C.ub4) error {
+	cValue := cString(value)
+	defer C.free(unsafe.Pointer(cValue))
+	return loader.conn.ociAttrSet(handle, handleType, unsafe.Pointer(cValue), C.ub4(len(value)), attributeType)
+}
+
+// AppendRow appends a row with a value for each column. Nil values are loaded as null.
+// The column array is loaded when full.
+func (loader *BulkLoader) AppendRow(values ...interface{}) error {
+	if loader.done {
+		return errors.New("bulk loader is finished")
+	}
+	if len(values) != loader.columnCount {
+		return fmt.Errorf("row has %v values, expected %v", len(values), loader.columnCount)
+	}
+
+	mark := len(loader.data)
+	for i := 0; i < len(values); i++ {
+		var err error
+		var isNull bool
+		start := len(loader.data)
+		loader.data, isNull, err = loader.appendValue(loader.data, values[i], loader.columnTypes[i])
+		if err != nil {
+			loader.data = loader.data[:mark]
+			loader.lengths = loader.lengths[:loader.rowCount*loader.columnCount]
+			return fmt.Errorf("column %v - error: %v", i, err)
+		}
+		length := int32(len(loader.data) - start)
+		if isNull {
+			length = -1
+		}
+		loader.lengths = append(loader.lengths, length)
+	}
+	loader.rowCount++
+
+	if loader.rowCount >= loader.maxRows {
+		return loader.Flush()
+	}
+	return nil
+}
+
+// AppendColumns appends rows from column slices, columns[i][j] is the value of column i of row j.
+// All columns must have the same number of values.
+func (loader *BulkLoader) AppendColumns(columns ...[]interface{}) error {
+	if len(columns) != loader.columnCount {
+		return fmt.Errorf("got %v columns, expected %v", len(columns), loader.columnCount)
+	}
+	rowCount := len(columns[0])
+	for i := 1; i < len(columns); i++ {
+		if len(columns[i]) != rowCount {
+			return fmt.Errorf("column %v has %v values, expected %v", i, len(columns[i]), rowCount)
+		}
+	}
+
+	row := make([]interface{}, len(columns))
+	for j := 0; j < rowCount; j++ {
+		for i := 0; i < len(columns); i++ {
+			row[i] = columns[i][j]
+		}
+		err := loader.AppendRow(row...)
+		if err != nil {
+			return fmt.Errorf("row %v %v", j, err)
+		}
+	}
+
+	return nil
+}
+
+// appendValue appends the text of value for a column of columnType to data and returns true if value is null
+func (loader *BulkLoader) appendValue(data []byte, value interface{}, columnType C.ub2) ([]byte, bool, error) {
+	value, err := driver.DefaultParameterConverter.ConvertValue(value)
+	if err != nil {
+		return data, false, err
+	}
+
+	switch value := value.(type) {
+	case nil:
+		return data, true, nil
+	case string:
+		data = append(data, value...)
+	case []byte:
+		if columnType != C.SQLT_BIN && columnType != C.SQLT_LBI {
+			data = append(data, value...)
+			break
+		}
+		// RAW columns are converted from hex text
+		start := len(data)
+		data = append(data, make([]byte, hex.EncodedLen(len(value)))...)
+		hex.Encode(data[start:], value)
+	case int64:
+		data = strconv.AppendInt(data, value, 10)
+	case float64:
+		data = strconv.AppendFloat(data, value, 'g', -1, 64)
+	case bool: // oracle does not have bool, handle as 0/1 int
+		if value {
+			data = append(data, '1')
+		} else {
+			data = append(data, '0')
+		}
+	case time.Time:
+		switch columnType {
+		case C.SQLT_TIMESTAMP, C.SQLT_TIMESTAMP_LTZ:
+			data = value.In(loader.conn.timeLocation).AppendFormat(data, bulkLoadTimestampLayout)
+		case C.SQLT_TIMESTAMP_TZ:
+			data = value.AppendFormat(data, bulkLoadTimestampTZLayout)
+		default:
+			data = value.In(loader.conn.timeLocation).AppendFormat(data, bulkLoadTimeLayout)
+		}
+	default:
+		return data, false, fmt.Errorf("unsupported type %T", value)
+	}
+
+	return data, false, nil
+}
+
+// Flush loads the appended rows.
+// The appended rows are discarded even when the load fails, as rows loaded before the error can not be told apart,
+// so Flush is not retried with them.
+func (loader *BulkLoader) Flush() error {
+	if loader.rowCount == 0 {
+		return nil
+	}
+
+	rowCount := loader.rowCount
+	armed := loader.conn.watchCancel(loader.ctx)
+	err := loader.load()
+	loader.conn.unwatchCancel(armed)
+
+	loader.rowCount = 0
+	loader.data = loader.data[:0]
+	loader.lengths = loader.lengths[:0]
+	C.OCIDirPathColArrayReset(loader.columnArray, loader.conn.errHandle)
+	C.OCIDirPathStreamReset(loader.stream, loader.conn.errHandle)
+
+	if err != nil {
+		return fmt.Errorf("%v, %v appended rows discarded", err, rowCount)
+	}
+	return nil
+}
+
+// load sets the column array from the appended rows, then converts it to streams and loads them.
+// A row with a value that can not be converted or loaded is rejected and the load goes on with the next row.
+func (loader *BulkLoader) load() error {
+	conn := loader.conn
+
+	// the column array points to the values, so they are copied to C memory
+	if len(loader.data) > loader.cDataSize {
+		C.free(loader.cData)
+		loader.cDataSize = len(loader.data) * 2
+		loader.cData = C.malloc(C.size_t(loader.cDataSize))
+	}
+	if len(loader.data) > 0 {
+		copy((*[1 << 30]byte)(loader.cData)[:len(loader.data):len(loader.data)], loader.data)
+	}
+
+	cells := loader.rowCount * loader.columnCount
+	values := (*[1 << 28]unsafe.Pointer)(loader.cValues)[:cells:cells]
+	lengths := (*[1 << 28]C.ub4)(loader.cLengths)[:cells:cells]
+	flags := (*[1 << 30]C.ub1)(loader.cFlags)[:cells:cells]
+	offset := 0
+	for i := 0; i < cells; i++ {
+		length := int(loader.lengths[i])
+		if length < 0 {
+			values[i] = nil
+			lengths[i] = 0
+			flags[i] = C.OCI_DIRPATH_COL_NULL
+			continue
+		}
+		values[i] = unsafe.Pointer(uintptr(loader.cData) + uintptr(offset))
+		lengths[i] = C.ub4(length)
+		flags[i] = C.OCI_DIRPATH_COL_COMPLETE
+		offset += length
+	}
+
+	result := C.ociDirPathColArraySet(
+		loader.columnArray,        // column array
+		conn.errHandle,            // error handle
+		C.ub4(loader.rowCount),    // number of rows to set
+		C.ub2(loader.columnCount), // number of columns of each row
+		(**C.ub1)(loader.cValues), // value pointers in row major order
+		(*C.ub4)(loader.cLengths), // value lengths in row major order
+		(*C.ub1)(loader.cFlags),   // value flags in row major order
+	)
+	err := conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("direct path column array error: %v", err)
+	}
+
+	rowOffset := 0
+	for rowOffset < loader.rowCount {
+		result = C.OCIDirPathColArrayToStream(
+			loader.columnArray,     // column array
+			loader.dpctx,           // direct path context
+			loader.stream,          // stream the rows are converted into
+			conn.errHandle,         // error handle
+			C.ub4(loader.rowCount), // number of rows in the column array
+			C.ub4(rowOffset),       // first row to convert
+		)
+		if result != C.OCI_SUCCESS && result != C.OCI_CONTINUE && result != C.OCI_ERROR {
+			return fmt.Errorf("direct path convert error: %v", conn.getError(result))
+		}
+		var convertError error
+		if result == C.OCI_ERROR {
+			convertError = conn.getError(result)
+		}
+
+		// rows converted by this call, before the row in error if any
+		var converted C.ub4
+		attrResult := C.OCIAttrGet(
+			unsafe.Pointer(loader.columnArray), // Pointer to a handle type
+			C.OCI_HTYPE_DIRPATH_COLUMN_ARRAY,   // The handle type
+			unsafe.Pointer(&converted),         // Pointer to the storage for an attribute value
+			nil,                                // The size of the attribute value
+			C.OCI_ATTR_ROW_COUNT,               // The attribute type
+			conn.errHandle,                     // An error handle
+		)
+		err = conn.getError(attrResult)
+		if err != nil {
+			return fmt.Errorf("direct path converted rows error: %v", err)
+		}
+
+		if converted > 0 {
+			err = loader.loadStream(int(converted))
+			if err != nil {
+				return err
+			}
+			loader.stats.Bytes += loader.rowBytes(rowOffset, rowOffset+int(converted))
+		}
+		C.OCIDirPathStreamReset(loader.stream, conn.errHandle)
+
+		rowOffset += int(converted)
+		if convertError != nil {
+			loader.reject(rowOffset, convertError)
+			rowOffset++
+		} else if converted == 0 && result != C.OCI_SUCCESS {
+			return errors.New("direct path convert made no progress")
+		}
+	}
+
+	return nil
+}
+
+// loadStream loads the converted rows in the stream.
+// After a row fails to load, loading goes on with the rows after it.
+func (loader *BulkLoader) loadStream(rows int) error {
+	conn := loader.conn
+	for attempt := 0; attempt <= rows; attempt++ {
+		result := C.OCIDirPathLoadStream(
+			loader.dpctx,   // direct path context
+			loader.stream,  // stream to load
+			conn.errHandle, // error handle
+		)
+		if result == C.OCI_SUCCESS {
+			loader.stats.Rows += int64(rows - attempt)
+			return nil
+		}
+		if result == C.OCI_NEED_DATA {
+			// the stream ends with a partial row, which is never the case as whole values are always set
+			return errors.New("direct path load error: stream ends with a partial row")
+		}
+		if result != C.OCI_ERROR {
+			return fmt.Errorf("direct path load error: %v", conn.getError(result))
+		}
+		loader.reject(-1, conn.getError(result))
+	}
+
+	return errors.New("direct path load made no progress")
+}
+
+// rowBytes returns the bytes of the non null values of the appended rows from start up to end
+func (loader *BulkLoader) rowBytes(start int, end int) int64 {
+	var bytes int64
+	for _, length := range loader.lengths[start*loader.columnCount : end*loader.columnCount] {
+		if length > 0 {
+			bytes += int64(length)
+		}
+	}
+	return bytes
+}
+
+// reject counts a rejected row and keeps its error
+func (loader *BulkLoader) reject(row int, err error) {
+	loader.stats.Rejected++
+	if len(loader.stats.Errors) < maxBulkLoadErrors {
+		if row >= 0 {
+			err = fmt.Errorf("row %v - error: %v", row, err)
+		}
+		loader.stats.Errors = append(loader.stats.Errors, err)
+	}
+}
+
+// Stats returns the counters of the load so far
+func (loader *BulkLoader) Stats() BulkLoadStats {
+	stats := loader.stats
+	stats.Elapsed = time.Since(loader.start)
+	stats.Errors = append([]error(nil), loader.stats.Errors...)
+	return stats
+}
+
+// RowsPerSecond returns the rows loaded per second
+func (stats BulkLoadStats) RowsPerSecond() float64 {
+	if stats.Elapsed <= 0 {
+		return 0
+	}
+	return float64(stats.Rows) / stats.Elapsed.Seconds()
+}
+
+// Finish loads the appended rows and commits the load, then frees the loader
+func (loader *BulkLoader) Finish() (BulkLoadStats, error) {
+	if loader.done {
+		return loader.Stats(), errors.New("bulk loader is finished")
+	}
+
+	err := loader.Flush()
+	if err != nil {
+		loader.abort()
+		return loader.Stats(), err
+	}
+
+	armed := loader.conn.watchCancel(loader.ctx)
+	result := C.OCIDirPathFinish(
+		loader.dpctx,          // direct path context
+		loader.conn.errHandle, // error handle
+	)
+	loader.conn.unwatchCancel(armed)
+	err = loader.conn.getError(result)
+	if err != nil {
+		loader.abort()
+		return loader.Stats(), fmt.Errorf("direct path finish error: %v", err)
+	}
+
+	stats := loader.Stats()
+	loader.free()
+	return stats, nil
+}
+
+// Abort discards the loaded rows and frees the loader
+func (loader *BulkLoader) Abort() error {
+	if loader.done {
+		return nil
+	}
+	return loader.abort()
+}
+
+// abort calls OCIDirPathAbort then frees the loader
+func (loader *BulkLoader) abort() error {
+	result := C.OCIDirPathAbort(
+		loader.dpctx,          // direct path context
+		loader.conn.errHandle, // error handle
+	)
+	err := loader.conn.getError(result)
+	loader.free()
+	return err
+}
+
+// free frees the handles and buffers of the loader
+func (loader *BulkLoader) free() {
+	loader.done = true
+	if loader.stream != nil {
+		C.OCIHandleFree(unsafe.Pointer(loader.stream), C.OCI_HTYPE_DIRPATH_STREAM)
+		loader.stream = nil
+	}
+	if loader.columnArray != nil {
+		C.OCIHandleFree(unsafe.Pointer(loader.columnArray), C.OCI_HTYPE_DIRPATH_COLUMN_ARRAY)
+		loader.columnArray = nil
+	}
+	if loader.dpctx != nil {
+		C.OCIHandleFree(unsafe.Pointer(loader.dpctx), C.OCI_HTYPE_DIRPATH_CTX)
+		loader.dpctx = nil
+	}
+	for _, buffer := range []*unsafe.Pointer{&loader.cValues, &loader.cLengths, &loader.cFlags, &loader.cData} {
+		if *buffer != nil {
+			C.free(*buffer)
+			*buffer = nil
+		}
+	}
+	loader.cDataSize = 0
+	loader.data = nil
+	loader.lengths = nil
+}
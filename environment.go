@@ -0,0 +1,179 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"errors"
+	"os"
+	"sync"
+	"unsafe"
+)
+
+const (
+	// maxPooledHandles is the max number of free handles or descriptors of one type kept by an environment
+	maxPooledHandles = 64
+)
+
+type (
+	// environmentStruct is an OCI environment handle shared by all connections using the same character set and NLS settings.
+	// It also keeps free lists of handles and descriptors so connections and statements can reuse them.
+	environmentStruct struct {
+		env         *C.OCIEnv
+		mode        C.ub4 // mode the environment was created with
+		mutex       sync.Mutex
+		handles     map[C.ub4][]unsafe.Pointer
+		descriptors map[C.ub4][]unsafe.Pointer
+	}
+
+	// environmentKey is the key of a shared environment
+	environmentKey struct {
+		charset C.ub2
+		nlsLang string
+		nlsChar string
+		mode    C.ub4
+	}
+)
+
+var (
+	environmentsMutex sync.Mutex
+	environments      = make(map[environmentKey]*environmentStruct)
+)
+
+// getEnvironment returns the shared environment for the current NLS settings and mode, creating it if needed.
+// mode is added to OCI_THREADED. Shared environments live for the life of the process.
+func getEnvironment(mode C.ub4) (*environmentStruct, error) {
+	key := environmentKey{
+		nlsLang: os.Getenv("NLS_LANG"),
+		nlsChar: os.Getenv("NLS_NCHAR"),
+		mode:    C.OCI_THREADED | mode,
+	}
+	if key.nlsLang == "" && key.nlsChar == "" {
+		key.charset = defaultCharset
+	}
+
+	environmentsMutex.Lock()
+	defer environmentsMutex.Unlock()
+
+	if environment, ok := environments[key]; ok {
+		return environment, nil
+	}
+
+	var envP *C.OCIEnv
+	envPP := &envP
+	result := C.OCIEnvNlsCreate(
+		envPP,       // pointer to a handle to the environment
+		key.mode,    // environment mode: https://docs.oracle.com/cd/B28359_01/appdev.111/b28395/oci16rel001.htm#LNOCI87683
+		nil,         // Specifies the user-defined context for the memory callback routines.
+		nil,         // Specifies the user-defined memory allocation function. If mode is OCI_THREADED, this memory allocation routine must be thread-safe.
+		nil,         // Specifies the user-defined memory re-allocation function. If the mode is OCI_THREADED, this memory allocation routine must be thread safe.
+		nil,         // Specifies the user-defined memory free function. If mode is OCI_THREADED, this memory free routine must be thread-safe.
+		0,           // Specifies the amount of user memory to be allocated for the duration of the environment.
+		nil,         // Returns a pointer to the user memory of size xtramemsz allocated by the call for the user.
+		key.charset, // The client-side character set for the current environment handle. If it is 0, the NLS_LANG setting is used.
+		key.charset, // The client-side national character set for the current environment handle. If it is 0, NLS_NCHAR setting is used.
+	)
+	if result != C.OCI_SUCCESS {
+		return nil, errors.New("OCIEnvNlsCreate error")
+	}
+
+	environment := &environmentStruct{
+		env:         *envPP,
+		mode:        key.mode,
+		handles:     make(map[C.ub4][]unsafe.Pointer),
+		descriptors: make(map[C.ub4][]unsafe.Pointer),
+	}
+	environments[key] = environment
+
+	return environment, nil
+}
+
+// handleGet returns a free handle of handleType or allocates a new one
+func (environment *environmentStruct) handleGet(handleType C.ub4) (unsafe.Pointer, error) {
+	environment.mutex.Lock()
+	free := environment.handles[handleType]
+	if len(free) > 0 {
+		handle := free[len(free)-1]
+		environment.handles[handleType] = free[:len(free)-1]
+		environment.mutex.Unlock()
+		return handle, nil
+	}
+	environment.mutex.Unlock()
+
+	var handle unsafe.Pointer
+	result := C.OCIHandleAlloc(
+		unsafe.Pointer(environment.env), // An environment handle
+		&handle,                         // Returns a handle
+		handleType,                      // type of handle: https://docs.oracle.com/cd/B28359_01/appdev.111/b28395/oci02bas.htm#LNOCI87581
+		0,                               // amount of user memory to be allocated
+		nil,                             // Returns a pointer to the user memory
+	)
+	if result != C.OCI_SUCCESS {
+		return nil, errors.New("OCIHandleAlloc error")
+	}
+
+	return handle, nil
+}
+
+// handlePut returns a handle to the free list, freeing it if the free list is full
+func (environment *environmentStruct) handlePut(handleType C.ub4, handle unsafe.Pointer) {
+	if handle == nil {
+		return
+	}
+
+	environment.mutex.Lock()
+	free := environment.handles[handleType]
+	if len(free) < maxPooledHandles {
+		environment.handles[handleType] = append(free, handle)
+		environment.mutex.Unlock()
+		return
+	}
+	environment.mutex.Unlock()
+
+	C.OCIHandleFree(handle, handleType)
+}
+
+// descriptorGet returns a free descriptor of descriptorType or allocates a new one
+func (environment *environmentStruct) descriptorGet(descriptorType C.ub4) (unsafe.Pointer, error) {
+	environment.mutex.Lock()
+	free := environment.descriptors[descriptorType]
+	if len(free) > 0 {
+		descriptor := free[len(free)-1]
+		environment.descriptors[descriptorType] = free[:len(free)-1]
+		environment.mutex.Unlock()
+		return descriptor, nil
+	}
+	environment.mutex.Unlock()
+
+	var descriptor unsafe.Pointer
+	result := C.OCIDescriptorAlloc(
+		unsafe.Pointer(environment.env), // An environment handle
+		&descriptor,                     // Returns a descriptor or LOB locator of desired type
+		descriptorType,                  // Specifies the type of descriptor or LOB locator to be allocated
+		0,                               // Specifies an amount of user memory to be allocated for use by the application for the lifetime of the descriptor
+		nil,                             // Returns a pointer to the user memory of size xtramem_sz allocated by the call for the user for the lifetime of the descriptor
+	)
+	if result != C.OCI_SUCCESS {
+		return nil, errors.New("OCIDescriptorAlloc error")
+	}
+
+	return descriptor, nil
+}
+
+// descriptorPut returns a descriptor to the free list, freeing it if the free list is full
+func (environment *environmentStruct) descriptorPut(descriptorType C.ub4, descriptor unsafe.Pointer) {
+	if descriptor == nil {
+		return
+	}
+
+	environment.mutex.Lock()
+	free := environment.descriptors[descriptorType]
+	if len(free) < maxPooledHandles {
+		environment.descriptors[descriptorType] = append(free, descriptor)
+		environment.mutex.Unlock()
+		return
+	}
+	environment.mutex.Unlock()
+
+	C.OCIDescriptorFree(descriptor, descriptorType)
+}
@@ -12,7 +12,9 @@ import "C"
 import (
 	"context"
 	"database/sql"
+	"database/sql/driver"
 	"errors"
+	"io"
 	"io/ioutil"
 	"log"
 	"reflect"
@@ -25,6 +27,12 @@ import (
 
 const (
 	lobBufferSize      = 4000
+	lobStreamSize      = 1 << 20 // max size of the buffer used by Lob.WriteTo
+	lobArrayReadSize   = 16384   // bytes read for each LOB by the batched LOB read, larger LOBs are then read one by one
+	lobArrayReadCount  = 1024    // max LOBs read by one OCILobArrayRead call, so the arena is at most 16 MB
+	streamPieceSize    = 1 << 16 // default bytes sent in each piece of a StreamValue bind
+	prefetchStartRows  = 16      // rows prefetched by the execute of an adaptive prefetch query, grown as it is fetched
+	maxArraySize       = 1 << 24 // max rows of an ExecBatch and max fetch array size, so C arrays fit the Go array types they are sliced with
 	useOCISessionBegin = true
 	sizeOfNilPointer   = unsafe.Sizeof(unsafe.Pointer(nil))
 )
@@ -37,11 +45,22 @@ type (
 		Password             string
 		prefetchRows         C.ub4
 		prefetchMemory       C.ub4
+		prefetchBudget       int
+		fetchArraySize       int
+		lobPrefetchSize      int
+		lobInlineSize        int
 		timeLocation         *time.Location
 		transactionMode      C.ub4
 		enableQMPlaceholders bool
+		exactNumbers         bool
+		dateBinds            bool
 		operationMode        C.ub4
+		environmentMode      C.ub4 // OCI_OBJECT and OCI_EVENTS modes of the environment, added to OCI_THREADED
 		stmtCacheSize        C.ub4
+		sessionPool          bool
+		poolMin              C.ub4
+		poolMax              C.ub4
+		poolIncr             C.ub4
 	}
 
 	// DriverStruct is Oracle driver struct
@@ -55,6 +74,20 @@ type (
 	Connector struct {
 		// Logger is used to log connection ping errors
 		Logger *log.Logger
+		// Cooldown is how long an endpoint that failed to connect is taken out of rotation. Defaults to 30 seconds.
+		Cooldown time.Duration
+
+		dsn       *DSN
+		mutex     sync.Mutex
+		endpoints []*endpointStruct
+	}
+
+	// endpointStruct is a connect string of a Connector with its load balancing state
+	endpointStruct struct {
+		connect       string
+		inFlight      int64         // connections opening or open to the endpoint, updated atomically
+		latency       time.Duration // moving average of connect latency, guarded by the Connector mutex
+		cooldownUntil time.Time     // endpoint is out of rotation until then, guarded by the Connector mutex
 	}
 
 	// Conn is Oracle connection
@@ -62,19 +95,34 @@ type (
 		svc                  *C.OCISvcCtx
 		srv                  *C.OCIServer
 		env                  *C.OCIEnv
+		environment          *environmentStruct
 		errHandle            *C.OCIError
 		usrSession           *C.OCISession
 		txHandle             *C.OCITrans
+		sessionPool          *sessionPoolStruct
 		prefetchRows         C.ub4
 		prefetchMemory       C.ub4
+		prefetchBudget       int
+		fetchArraySize       int
+		lobPrefetchSize      int
+		lobInlineSize        int
 		transactionMode      C.ub4
 		operationMode        C.ub4
 		stmtCacheSize        C.ub4
 		inTransaction        bool
 		enableQMPlaceholders bool
+		exactNumbers         bool
+		dateBinds            bool
 		closed               bool
+		badConnection        bool
 		timeLocation         *time.Location
 		logger               *log.Logger
+		endpoint             *endpointStruct
+		cancelMutex          sync.Mutex           // guards cancelArm and closed between watchCancel and Close
+		cancelArm            chan context.Context // arms the cancel watcher goroutine with a ctx
+		cancelDisarm         chan struct{}        // disarms the cancel watcher goroutine
+		callTimeout          C.ub4                // milliseconds last set as OCI_ATTR_CALL_TIMEOUT
+		defineCache          map[string]*defineCacheStruct
 	}
 
 	// Tx is Oracle transaction
@@ -90,15 +138,56 @@ type (
 		ctx         context.Context
 		cacheKey    string // if statement caching is enabled, this is the key for this statement into the cache
 		releaseMode C.ub4
+		binds       []bindStruct        // bind buffers kept across executions, indexed by placeholder position
+		streams     []*streamBindStruct // StreamValue binds of the current execution, sent piece by piece
+		prefetch    prefetchStruct      // prefetch attributes last set on the statement handle
+		prefetchSet bool                // prefetch has been set, so unchanged values are not set again
 	}
 
 	// Rows is Oracle rows
 	Rows struct {
-		stmt    *Stmt
-		defines []defineStruct
-		closed  bool
+		stmt         *Stmt
+		defines      []defineStruct
+		closed       bool
+		fetched      int                        // number of rows in the defines buffers from the last fetch
+		index        int                        // index of the next row to return from the defines buffers
+		endOfFetch   bool                       // the last fetch returned OCI_NO_DATA
+		decoders     []columnDecoder            // decoder of each column, made once when the rows are created
+		lobs         map[*Lob]struct{}          // open Lob values, closed with the rows
+		documents    map[*JSONDocument]struct{} // open JSONDocument values, closed with the rows
+		lobValues    [][]driver.Value           // values of LOB columns for each row of the fetched batch, nil when LOBs are read per cell
+		lobArena     unsafe.Pointer             // C buffer the batched LOB read reads into, kept across fetches
+		lobArenaSize int
+		prefetchRows int // adaptive prefetch rows last set, 0 when prefetch is not adaptive
+		prefetchMax  int // adaptive prefetch rows that fit in the memory budget
+		prefetchUsed int // rows fetched since prefetchRows was last set
+
+		implicitStmt      *Stmt // executed PL/SQL block the implicit result sets are read from, nil if not an implicit result set
+		implicitRemaining int   // implicit result sets after this one
+
+		cursors  map[*Rows]struct{} // open REF CURSOR rows read from the define buffers, closed with the rows and before the next fetch
+		parent   *Rows              // rows with the define buffer holding the REF CURSOR handle of these rows, nil if not from a column
+		cursor   *unsafe.Pointer    // the handle in the define buffer of parent
+		ownsStmt bool               // the statement handle is from a REF CURSOR out bind and is freed when the rows close
+	}
+
+	// Lob is a CLOB or BLOB value that is read from the database on demand.
+	// It is returned instead of []byte or string for LOB columns of queries run with a context from WithLobStreaming.
+	// A Lob must be read before its rows are closed, and is closed with its rows if not closed before.
+	// A Lob is not safe for concurrent use.
+	Lob struct {
+		rows      *Rows
+		locator   *C.OCILobLocator
+		form      C.ub1
+		binary    bool  // BLOB, offsets are in bytes. CLOB offsets are in characters.
+		offset    int64 // 1 based offset of the next Read
+		size      int64 // length from OCILobGetLength2, -1 until known
+		chunkSize int
 	}
 
+	// columnDecoder converts a non null value in a define buffer to a driver.Value
+	columnDecoder func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error)
+
 	// Result is Oracle result
 	Result struct {
 		rowsAffected    int64
@@ -108,6 +197,214 @@ type (
 		stmt            *Stmt
 	}
 
+	// BatchResult is Oracle array DML result
+	BatchResult struct {
+		rowsAffected int64
+		rowCounts    []int64
+	}
+
+	// BulkLoader loads rows into a table with the OCI direct path API, which formats data blocks on the client
+	// and writes them above the high water mark, bypassing SQL insert processing.
+	// Appended rows are buffered in a column array that is converted to direct path streams and loaded when full
+	// or on Flush. A BulkLoader is not safe for concurrent use, for a parallel load open one per connection.
+	BulkLoader struct {
+		conn        *Conn
+		ctx         context.Context
+		dpctx       *C.OCIDirPathCtx
+		columnArray *C.OCIDirPathColArray
+		stream      *C.OCIDirPathStream
+		columnCount int
+		columnTypes []C.ub2 // data type of each loaded column in the table, 0 if not described
+		maxRows     int     // rows of the column array
+		rowCount    int     // rows appended to the column array and not loaded yet
+		data        []byte  // values of the appended rows
+		lengths     []int32 // length of each appended value in data, -1 for null
+		cValues     unsafe.Pointer
+		cLengths    unsafe.Pointer
+		cFlags      unsafe.Pointer
+		cData       unsafe.Pointer
+		cDataSize   int
+		start       time.Time
+		stats       BulkLoadStats
+		done        bool
+	}
+
+	// BulkLoaderOptions are the options of a BulkLoader
+	BulkLoaderOptions struct {
+		Schema        string // schema of the table, defaults to the user
+		Partition     string // partition or subpartition to load, defaults to the whole table
+		MaxColumnSize int    // max bytes of a value, defaults to 4000
+		BufferSize    int    // bytes of each direct path stream sent to the server, defaults to the OCI default
+		Parallel      bool   // allow loaders in other sessions to load the same table at the same time, indexes are not maintained
+		NoLogging     bool   // do not write the loaded data blocks to the redo log
+	}
+
+	// BulkLoadStats are the counters of a BulkLoader
+	BulkLoadStats struct {
+		Rows     int64         // rows loaded
+		Rejected int64         // rows rejected because a value could not be converted or loaded
+		Bytes    int64         // bytes of the values sent to the server, including those of rows it rejected
+		Elapsed  time.Duration // time since the loader was opened
+		Errors   []error       // errors of the first rejected rows
+	}
+
+	// Queue enqueues and dequeues batches of messages with RAW payloads on an Oracle Advanced Queuing queue.
+	// The message property descriptors and payloads of a batch are kept and reused by the next batch.
+	// A Queue is not safe for concurrent use and uses its connection, so the connection must not be used at the same time.
+	Queue struct {
+		conn              *Conn
+		name              *C.OraText
+		payloadType       *C.OCIType
+		enqueueOptions    unsafe.Pointer
+		dequeueOptions    unsafe.Pointer
+		capacity          int            // messages of the arrays below
+		properties        unsafe.Pointer // message properties descriptors
+		payloads          unsafe.Pointer // OCIRaw payloads
+		ids               unsafe.Pointer // OCIRaw message ids
+		indicators        unsafe.Pointer // payload null indicators
+		indicatorPointers unsafe.Pointer // pointers to the payload null indicators
+		fields            unsafe.Pointer // ociAQMessageFields
+		closed            bool
+	}
+
+	// QueueOptions are the options of a Queue
+	QueueOptions struct {
+		Consumer    string // subscriber to dequeue as, for multiple consumer queues
+		Correlation string // dequeue only messages with this correlation, % and _ are wildcards
+	}
+
+	// Message is a queue message. ID, Attempts, and EnqueueTime are set by enqueue and dequeue.
+	Message struct {
+		ID          []byte
+		Payload     []byte
+		Correlation string
+		Priority    int           // lower values are dequeued first
+		Delay       time.Duration // time before the message can be dequeued, truncated to whole seconds
+		Expiration  time.Duration // time the message can be dequeued for once the delay is over, truncated to whole seconds, 0 never expires
+		Attempts    int
+		EnqueueTime time.Time
+	}
+
+	// ConsumeError is returned by Queue.Consume when the handler returns an error.
+	// Messages outside a transaction are removed from the queue when dequeued, so the ones not handled are returned in it.
+	ConsumeError struct {
+		Err      error     // error returned by the handler
+		Messages []Message // the batch the handler failed on, followed by the batches dequeued after it, in order
+	}
+
+	// Subscription is a continuous query notification registration. Changes to the results of the queries
+	// registered with it, or to their tables, are delivered on the Events channel.
+	// The database connects back to the client to deliver notifications, so the client must be reachable from it.
+	Subscription struct {
+		conn         *Conn
+		handle       *C.OCISubscription
+		errHandle    *C.OCIError // error handle of the notification callback, which runs on an OCI thread
+		id           uint64
+		queryLevel   bool
+		events       chan SubscriptionEvent
+		mutex        sync.Mutex // guards events, missed, closed, and deregistered against the notification callback
+		missed       int
+		closed       bool
+		deregistered bool // removed by the database, so Close does not unregister it
+	}
+
+	// SubscriptionOptions are the options of a Subscription
+	SubscriptionOptions struct {
+		QueryLevel bool          // notify only when the result of a registered query changes, else when one of its tables changes
+		Rowids     bool          // include the rowids of changed rows
+		Timeout    time.Duration // the registration is removed by the database after the timeout, 0 never times out
+		Port       int           // client port the database sends notifications to, 0 picks a free port
+		BufferSize int           // events buffered by the Events channel, defaults to 64
+	}
+
+	// SubscriptionEvent is a change notification
+	SubscriptionEvent struct {
+		Type     int // one of the Event constants
+		Database string
+		Tables   []TableChange // changed tables, for EventObjectChange
+		Queries  []QueryChange // changed queries, for EventQueryChange
+		Missed   int           // events dropped before this one because Events was full, cached data should be fully invalidated
+	}
+
+	// QueryChange is a change of the result of a registered query
+	QueryChange struct {
+		ID        uint64 // query id returned by Register
+		Operation int
+		Tables    []TableChange
+	}
+
+	// TableChange is a change of a table. Operation is a combination of the Operation flags.
+	// Rows is nil when rowids were not requested or when the database invalidated all rows, with OperationAllRows.
+	TableChange struct {
+		Name      string
+		Operation int
+		Rows      []RowChange
+	}
+
+	// RowChange is a change of a row
+	RowChange struct {
+		Rowid     string
+		Operation int
+	}
+
+	// XStreamOut is a connection attached to an XStream outbound server
+	XStreamOut struct {
+		conn        *Conn
+		capacity    int            // LCRs of the arrays below
+		lcrs        unsafe.Pointer // received LCRs
+		types       unsafe.Pointer // LCR types
+		flags       unsafe.Pointer // LCR flags
+		headers     unsafe.Pointer // ociLCRHeader
+		columns     unsafe.Pointer // ociLCRColumn
+		columnCount int            // columns of the columns array
+		inCall      bool           // an OCIXStreamOutLCRReceive call is streaming
+		lowPosition []byte
+		attached    bool
+	}
+
+	// LCR is a logical change record received from an XStream outbound server
+	LCR struct {
+		Type           int    // LCRRow or LCRDDL
+		Command        string // INSERT, UPDATE, DELETE, LOB WRITE, COMMIT, or the DDL command
+		SourceDatabase string
+		Owner          string
+		Object         string
+		TransactionID  string
+		Tag            []byte
+		SourceTime     time.Time
+		Position       []byte
+		OldColumns     []LCRColumn // for row LCRs, before image of UPDATE and DELETE
+		NewColumns     []LCRColumn // for row LCRs, after image of INSERT and UPDATE, and LOB data
+	}
+
+	// LCRColumn is a column value of a row LCR
+	LCRColumn struct {
+		Name  string
+		Value interface{}
+	}
+
+	// JSON is a value of a native JSON column, bound and fetched in the binary OSON format.
+	// As a bind value, Value is encoded with encoding/json, except json.RawMessage, []byte, and string which must be JSON text.
+	// As a Scan destination, the column is decoded with encoding/json into Value, which must be a pointer.
+	JSON struct {
+		Value interface{}
+	}
+
+	// JSONDocument is a native JSON column value returned for queries run with a WithJSONStreaming context.
+	// Its text is converted from the binary value only when read, piece by piece.
+	// A JSONDocument must be read before its rows are closed, and is closed with its rows if not closed before.
+	JSONDocument struct {
+		rows *Rows
+		json *C.OCIJson
+	}
+
+	// jsonWriterStruct is the writer of a JSONDocument.WriteTo call
+	jsonWriterStruct struct {
+		writer  io.Writer
+		written int64
+		err     error
+	}
+
 	defineStruct struct {
 		name         string
 		dataType     C.ub2
@@ -116,7 +413,20 @@ type (
 		length       *C.ub2
 		indicator    *C.sb2
 		defineHandle *C.OCIDefine
-		subDefines   []defineStruct
+		arraySize    int // number of rows in pbuf, length, and indicator
+	}
+
+	// prefetchStruct is the prefetch of a query: a fixed number of rows and memory, or an adaptive memory budget
+	prefetchStruct struct {
+		rows   int
+		memory int
+		budget int // bytes, when not 0 the rows are computed from the row width and memory is not limited
+	}
+
+	// defineCacheStruct is the described select-list of a cached statement and the define buffers of its last closed rows
+	defineCacheStruct struct {
+		columns []defineStruct // name, define data type, and buffer size of each column, without buffers
+		defines []defineStruct // buffers ready to be defined again, nil when not available
 	}
 
 	bindStruct struct {
@@ -127,6 +437,30 @@ type (
 		indicator  *C.sb2
 		bindHandle *C.OCIBind
 		out        sql.Out
+		arraySize  int                // number of elements in pbuf, length, and indicator for array binds
+		name       string             // placeholder name for binds kept by the statement, empty when bound by position
+		lobConn    *Conn              // set when pbuf is a temporary LOB, freed with OCILobFreeTemporary on this connection
+		stream     *streamBindStruct  // set for a StreamValue bound with OCI_DATA_AT_EXEC
+		dateTimes  *environmentStruct // set when the SQLT_TIMESTAMP_TZ descriptors of pbuf go back to the pool of this environment
+	}
+
+	// StreamValue is a bind value read from Reader while the statement executes, piece by piece,
+	// so large values can be inserted into LOB or LONG columns without holding them in memory.
+	StreamValue struct {
+		Reader    io.Reader
+		Size      int64 // total size in bytes if known, values over 2 GB need it. 0 if unknown.
+		Text      bool  // bind as character data for a CLOB or LONG column, otherwise binary for a BLOB or LONG RAW column
+		PieceSize int   // bytes sent in each piece. Defaults to 64 KB.
+	}
+
+	// streamBindStruct is the state of a StreamValue bind
+	streamBindStruct struct {
+		value      StreamValue
+		bindHandle *C.OCIBind
+		buffer     unsafe.Pointer // C buffer of PieceSize bytes the Reader reads into
+		length     *C.ub4         // C length of the piece in buffer
+		sent       int64          // bytes sent so far
+		done       bool           // the last piece was sent
 	}
 )
 
@@ -147,15 +481,20 @@ var (
 	// ErrNoRowid is result has no rowid
 	ErrNoRowid = errors.New("result has no rowid")
 
+	// errLobArrayReadUnsupported is returned by the batched LOB read when the server does not support OCILobArrayRead
+	errLobArrayReadUnsupported = errors.New("OCILobArrayRead is not supported")
+
 	phre           = regexp.MustCompile(`\?`)
 	defaultCharset = C.ub2(0)
 
-	typeNil       = reflect.TypeOf(nil)
-	typeString    = reflect.TypeOf("a")
-	typeSliceByte = reflect.TypeOf([]byte{})
-	typeInt64     = reflect.TypeOf(int64(1))
-	typeFloat64   = reflect.TypeOf(float64(1))
-	typeTime      = reflect.TypeOf(time.Time{})
+	typeNil          = reflect.TypeOf(nil)
+	typeString       = reflect.TypeOf("a")
+	typeSliceByte    = reflect.TypeOf([]byte{})
+	typeInt64        = reflect.TypeOf(int64(1))
+	typeFloat64      = reflect.TypeOf(float64(1))
+	typeTime         = reflect.TypeOf(time.Time{})
+	typeLob          = reflect.TypeOf((*Lob)(nil))
+	typeJSONDocument = reflect.TypeOf((*JSONDocument)(nil))
 
 	// Driver is the sql driver
 	Driver = &DriverStruct{
@@ -164,6 +503,21 @@ var (
 
 	timeLocations []*time.Location
 
+	// offsetLocations caches fixed zones by offset in seconds for offsets not in timeLocations
+	offsetLocations sync.Map
+	// regionLocations caches locations by Oracle time zone region name, nil when Go does not know the region
+	regionLocations sync.Map
+
+	// subscriptions are the open subscriptions by id, the id is the context of their notification callback
+	subscriptions sync.Map
+	// subscriptionLastID is the id of the last subscription
+	subscriptionLastID uint64
+
+	// jsonWriters are the writers of running JSONDocument.WriteTo calls by id, the id is the id of their stream
+	jsonWriters sync.Map
+	// jsonWriterLastID is the id of the last JSON writer
+	jsonWriterLastID uint64
+
 	byteBufferPool = sync.Pool{
 		New: func() interface{} {
 			return make([]byte, lobBufferSize)
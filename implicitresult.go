@@ -0,0 +1,76 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"fmt"
+	"io"
+	"unsafe"
+)
+
+// implicitResultCount returns the number of implicit result sets returned by the executed PL/SQL block
+// with DBMS_SQL.RETURN_RESULT. Clients and servers before 12.1 do not have implicit results, so errors count as 0.
+func (stmt *Stmt) implicitResultCount() int {
+	var implicitResultCount C.ub4
+	_, err := stmt.ociAttrGet(unsafe.Pointer(&implicitResultCount), C.OCI_ATTR_IMPLICIT_RESULT_COUNT)
+	if err != nil {
+		return 0
+	}
+	return int(implicitResultCount)
+}
+
+// nextImplicitResult sets rows to the next implicit result set of the executed statement, defined for fetching.
+// Returns io.EOF if there are no more.
+func (stmt *Stmt) nextImplicitResult(rows *Rows) error {
+	var result unsafe.Pointer
+	var resultType C.ub4
+	status := C.OCIStmtGetNextResult(
+		stmt.stmt,           // statement handle of the executed PL/SQL block
+		stmt.conn.errHandle, // error handle
+		&result,             // returns the statement handle of the result set
+		&resultType,         // returns the type of the result, OCI_RESULT_TYPE_SELECT
+		C.OCI_DEFAULT,       // mode
+	)
+	if status == C.OCI_NO_DATA {
+		return io.EOF
+	}
+	if status != C.OCI_SUCCESS && status != C.OCI_SUCCESS_WITH_INFO {
+		return stmt.conn.getError(status)
+	}
+	if resultType != C.OCI_RESULT_TYPE_SELECT {
+		return fmt.Errorf("unsupported implicit result type %v", resultType)
+	}
+
+	// the statement handle of the result set belongs to stmt and is freed with it
+	err := stmt.conn.defineCursor(rows, (*C.OCIStmt)(result), stmt.ctx)
+	if err != nil {
+		return err
+	}
+	rows.implicitStmt = stmt
+	return nil
+}
+
+// HasNextResultSet returns true if the PL/SQL block returned more implicit result sets
+func (rows *Rows) HasNextResultSet() bool {
+	return rows.implicitRemaining > 0
+}
+
+// NextResultSet closes the current result set and advances to the next implicit result set
+func (rows *Rows) NextResultSet() error {
+	if rows.implicitRemaining < 1 {
+		return io.EOF
+	}
+	implicitStmt := rows.implicitStmt
+	implicitRemaining := rows.implicitRemaining - 1
+
+	rows.Close()
+
+	err := implicitStmt.nextImplicitResult(rows)
+	if err != nil {
+		return err
+	}
+	rows.implicitRemaining = implicitRemaining
+
+	return nil
+}
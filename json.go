@@ -0,0 +1,212 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"encoding/json"
+	"fmt"
+	"io"
+	"sync/atomic"
+	"unsafe"
+)
+
+// Scan decodes the JSON column value src into Value with encoding/json.
+// src is the JSON text, or a *JSONDocument for queries run with a WithJSONStreaming context.
+func (value JSON) Scan(src interface{}) error {
+	switch src := src.(type) {
+	case nil:
+		return json.Unmarshal([]byte("null"), value.Value)
+	case []byte:
+		return json.Unmarshal(src, value.Value)
+	case string:
+		return json.Unmarshal([]byte(src), value.Value)
+	case *JSONDocument:
+		err := src.Decode(value.Value)
+		closeErr := src.Close()
+		if err != nil {
+			return err
+		}
+		return closeErr
+	}
+	return fmt.Errorf("unsupported JSON scan type %T", src)
+}
+
+// text returns the JSON text of Value
+func (value JSON) text() ([]byte, error) {
+	switch text := value.Value.(type) {
+	case json.RawMessage:
+		return text, nil
+	case []byte:
+		return text, nil
+	case string:
+		return []byte(text), nil
+	}
+	return json.Marshal(value.Value)
+}
+
+// bindJSON sets sbind to a JSON descriptor holding value, parsed to the binary format in the client
+func (stmt *Stmt) bindJSON(sbind *bindStruct, value JSON) error {
+	text, err := value.text()
+	if err != nil {
+		return fmt.Errorf("encode JSON error: %v", err)
+	}
+
+	sbind.pbuf, err = stmt.conn.ociDescriptorAllocArray(C.OCI_DTYPE_JSON, 1)
+	if err != nil {
+		return fmt.Errorf("allocate JSON descriptor error: %v", err)
+	}
+	sbind.dataType = C.SQLT_JSON
+	sbind.arraySize = 1 // freed as an array of one descriptor
+	sbind.maxSize = C.sb4(sizeOfNilPointer)
+	*sbind.length = C.ub2(sizeOfNilPointer)
+
+	if value.Value == nil || len(text) == 0 {
+		*sbind.indicator = -1 // set to null
+		return nil
+	}
+
+	cText := C.CBytes(text)
+	defer C.free(cText)
+	result := C.OCIJsonTextBufferParse(
+		unsafe.Pointer(stmt.conn.svc), // service context
+		*(**C.OCIJson)(sbind.pbuf),    // JSON descriptor
+		cText,                         // JSON text
+		C.oraub8(len(text)),           // JSON text length
+		C.JZN_ALLOW_SCALAR_DOCUMENTS,  // validation: standard JSON, top level scalars allowed
+		C.JZN_INPUT_UTF8,              // encoding of the text
+		stmt.conn.errHandle,           // error handle
+		C.OCI_DEFAULT,                 // mode
+	)
+	err = stmt.conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("parse JSON error: %v", err)
+	}
+
+	return nil
+}
+
+// ociJSONToText converts a JSON descriptor to text in the client, in one cgo call
+func (conn *Conn) ociJSONToText(jsonDescriptor *C.OCIJson) ([]byte, error) {
+	var text C.ociJsonText
+	result := C.ociJsonToText(conn.svc, conn.errHandle, jsonDescriptor, &text)
+	defer C.free(unsafe.Pointer(text.data))
+	// OCI_SUCCESS_WITH_INFO is a warning, the text was still written
+	if result != C.OCI_SUCCESS_WITH_INFO {
+		err := conn.getError(result)
+		if err != nil {
+			return nil, fmt.Errorf("JSON to text error: %v", err)
+		}
+	}
+
+	return C.GoBytes(unsafe.Pointer(text.data), C.int(text.length)), nil
+}
+
+// newJSONDocument returns a JSONDocument with a copy of the JSON descriptor in a define buffer, closed with the rows
+func (rows *Rows) newJSONDocument(jsonDescriptor *C.OCIJson) (*JSONDocument, error) {
+	conn := rows.stmt.conn
+	descriptor, _, err := conn.ociDescriptorAlloc(C.OCI_DTYPE_JSON, 0)
+	if err != nil {
+		return nil, fmt.Errorf("allocate JSON descriptor error: %v", err)
+	}
+	document := &JSONDocument{
+		rows: rows,
+		json: (*C.OCIJson)(*descriptor),
+	}
+
+	result := C.OCIJsonClone(
+		conn.svc,       // service context
+		jsonDescriptor, // JSON descriptor to copy from
+		document.json,  // JSON descriptor to copy to
+		conn.errHandle, // error handle
+		C.OCI_DEFAULT,  // mode
+	)
+	err = conn.getError(result)
+	if err != nil {
+		document.Close()
+		return nil, fmt.Errorf("clone JSON descriptor error: %v", err)
+	}
+
+	if rows.documents == nil {
+		rows.documents = make(map[*JSONDocument]struct{})
+	}
+	rows.documents[document] = struct{}{}
+
+	return document, nil
+}
+
+// WriteTo writes the JSON text of the document to w. The text is converted from the binary value
+// and written in pieces as it is converted, so the whole text is never held in memory.
+func (document *JSONDocument) WriteTo(w io.Writer) (int64, error) {
+	if document.json == nil {
+		return 0, fmt.Errorf("JSON document is closed")
+	}
+
+	writer := &jsonWriterStruct{writer: w}
+	id := atomic.AddUint64(&jsonWriterLastID, 1)
+	jsonWriters.Store(id, writer)
+	defer jsonWriters.Delete(id)
+
+	conn := document.rows.stmt.conn
+	result := C.ociJsonToWriter(conn.svc, conn.errHandle, document.json, C.uintptr_t(id))
+	if writer.err != nil {
+		return writer.written, writer.err
+	}
+	if result != C.OCI_SUCCESS_WITH_INFO {
+		err := conn.getError(result)
+		if err != nil {
+			return writer.written, fmt.Errorf("JSON to text error: %v", err)
+		}
+	}
+
+	return writer.written, nil
+}
+
+// Decode decodes the JSON text of the document into v with encoding/json while it is converted from the binary value
+func (document *JSONDocument) Decode(v interface{}) error {
+	reader, writer := io.Pipe()
+	done := make(chan struct{})
+	go func() {
+		_, err := document.WriteTo(writer)
+		writer.CloseWithError(err)
+		close(done)
+	}()
+
+	err := json.NewDecoder(reader).Decode(v)
+	// stops WriteTo if the decoder did not read all the text
+	reader.Close()
+	<-done
+
+	return err
+}
+
+// Close frees the document. Close is called for all open JSONDocument values when their rows are closed.
+func (document *JSONDocument) Close() error {
+	if document.json == nil {
+		return nil
+	}
+	C.OCIDescriptorFree(unsafe.Pointer(document.json), C.OCI_DTYPE_JSON)
+	document.json = nil
+	delete(document.rows.documents, document)
+	return nil
+}
+
+//export gobciJSONWrite
+func gobciJSONWrite(id C.uintptr_t, source unsafe.Pointer, size C.size_t) C.int {
+	value, ok := jsonWriters.Load(uint64(id))
+	if !ok {
+		return 1
+	}
+	writer := value.(*jsonWriterStruct)
+
+	// io.Writer must not retain the slice, so the C memory is written without a copy
+	length := int(size)
+	n, err := writer.writer.Write((*[1 << 30]byte)(source)[:length:length])
+	writer.written += int64(n)
+	if err != nil {
+		writer.err = err
+		return 1
+	}
+
+	return 0
+}
@@ -0,0 +1,409 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"database/sql/driver"
+	"errors"
+	"fmt"
+	"io"
+	"unsafe"
+)
+
+// newLob returns a Lob with its own copy of lobLocator, so the define buffer can be fetched into again
+func (rows *Rows) newLob(lobLocator *C.OCILobLocator, binary bool) (*Lob, error) {
+	conn := rows.stmt.conn
+
+	descriptor, err := conn.environment.descriptorGet(C.OCI_DTYPE_LOB)
+	if err != nil {
+		return nil, err
+	}
+	lob := &Lob{
+		rows:    rows,
+		locator: (*C.OCILobLocator)(descriptor),
+		binary:  binary,
+		offset:  1,
+		size:    -1,
+	}
+
+	result := C.OCILobLocatorAssign(
+		conn.svc,       // service context handle
+		conn.errHandle, // error handle
+		lobLocator,     // LOB locator to copy from
+		&lob.locator,   // LOB locator to copy to
+	)
+	if result != C.OCI_SUCCESS {
+		conn.environment.descriptorPut(C.OCI_DTYPE_LOB, descriptor)
+		return nil, conn.getError(result)
+	}
+
+	// set character set form
+	result = C.OCILobCharSetForm(
+		conn.env,       // environment handle
+		conn.errHandle, // error handle
+		lob.locator,    // LOB locator
+		&lob.form,      // character set form
+	)
+	if result != C.OCI_SUCCESS {
+		conn.environment.descriptorPut(C.OCI_DTYPE_LOB, descriptor)
+		return nil, conn.getError(result)
+	}
+
+	if rows.lobs == nil {
+		rows.lobs = make(map[*Lob]struct{})
+	}
+	rows.lobs[lob] = struct{}{}
+
+	return lob, nil
+}
+
+// Close releases the LOB locator. Close is called for all open Lob values when their rows are closed.
+func (lob *Lob) Close() error {
+	if lob.locator == nil {
+		return nil
+	}
+
+	lob.rows.stmt.conn.environment.descriptorPut(C.OCI_DTYPE_LOB, unsafe.Pointer(lob.locator))
+	lob.locator = nil
+	delete(lob.rows.lobs, lob)
+
+	return nil
+}
+
+// Size returns the length of the LOB, in bytes for a BLOB and in characters for a CLOB.
+// It can be used to preallocate a buffer before reading a BLOB.
+func (lob *Lob) Size() (int64, error) {
+	if lob.size >= 0 {
+		return lob.size, nil
+	}
+	if lob.locator == nil {
+		return 0, errors.New("lob is closed")
+	}
+
+	conn := lob.rows.stmt.conn
+	var length C.oraub8
+	result := C.OCILobGetLength2(
+		conn.svc,       // service context handle
+		conn.errHandle, // error handle
+		lob.locator,    // LOB locator
+		&length,        // returns the length of the LOB
+	)
+	if result != C.OCI_SUCCESS {
+		return 0, conn.getError(result)
+	}
+
+	lob.size = int64(length)
+	return lob.size, nil
+}
+
+// ChunkSize returns the LOB chunk size in bytes. Reads with a buffer that is a multiple of the chunk size are the most efficient.
+func (lob *Lob) ChunkSize() (int, error) {
+	if lob.chunkSize > 0 {
+		return lob.chunkSize, nil
+	}
+	if lob.locator == nil {
+		return 0, errors.New("lob is closed")
+	}
+
+	conn := lob.rows.stmt.conn
+	var chunkSize C.ub4
+	result := C.OCILobGetChunkSize(
+		conn.svc,       // service context handle
+		conn.errHandle, // error handle
+		lob.locator,    // LOB locator
+		&chunkSize,     // returns the usable chunk size in bytes
+	)
+	if result != C.OCI_SUCCESS {
+		return 0, conn.getError(result)
+	}
+
+	lob.chunkSize = int(chunkSize)
+	if lob.chunkSize < 1 {
+		lob.chunkSize = lobBufferSize
+	}
+	return lob.chunkSize, nil
+}
+
+// Read reads the next bytes of the LOB into p. A CLOB is read in the client character set.
+func (lob *Lob) Read(p []byte) (int, error) {
+	if len(p) == 0 {
+		return 0, nil
+	}
+
+	byteCount, charCount, err := lob.read(p, lob.offset)
+	if lob.binary {
+		lob.offset += int64(byteCount)
+	} else {
+		lob.offset += int64(charCount)
+	}
+	return byteCount, err
+}
+
+// ReadAt reads len(p) bytes of a BLOB starting at byte offset off.
+// ReadAt is not supported for a CLOB because CLOB offsets are in characters.
+func (lob *Lob) ReadAt(p []byte, off int64) (int, error) {
+	if !lob.binary {
+		return 0, errors.New("ReadAt is not supported for CLOB")
+	}
+	if off < 0 {
+		return 0, errors.New("negative offset")
+	}
+
+	total := 0
+	for total < len(p) {
+		byteCount, _, err := lob.read(p[total:], off+int64(total)+1)
+		total += byteCount
+		if err != nil {
+			return total, err
+		}
+	}
+	return total, nil
+}
+
+// WriteTo writes the rest of the LOB to w, reading with a buffer that is a multiple of the LOB chunk size
+func (lob *Lob) WriteTo(w io.Writer) (int64, error) {
+	chunkSize, err := lob.ChunkSize()
+	if err != nil {
+		return 0, err
+	}
+	bufferSize := chunkSize
+	for bufferSize+chunkSize <= lobStreamSize {
+		bufferSize += chunkSize
+	}
+
+	size, err := lob.Size()
+	if err != nil {
+		return 0, err
+	}
+	if lob.offset > size {
+		return 0, nil
+	}
+	if lob.binary && size-lob.offset+1 < int64(bufferSize) {
+		// do not allocate more than what is left of a BLOB
+		bufferSize = int(size - lob.offset + 1)
+	}
+	buffer := make([]byte, bufferSize)
+
+	var total int64
+	for {
+		byteCount, readErr := lob.Read(buffer)
+		if byteCount > 0 {
+			written, err := w.Write(buffer[:byteCount])
+			total += int64(written)
+			if err != nil {
+				return total, err
+			}
+		}
+		if readErr == io.EOF {
+			return total, nil
+		}
+		if readErr != nil {
+			return total, readErr
+		}
+	}
+}
+
+// read calls OCILobRead2 once to read up to len(p) bytes at the 1 based offset,
+// returns the bytes read and, for a CLOB, the characters read
+func (lob *Lob) read(p []byte, offset int64) (int, int, error) {
+	if lob.locator == nil {
+		return 0, 0, errors.New("lob is closed")
+	}
+
+	size, err := lob.Size()
+	if err != nil {
+		return 0, 0, err
+	}
+	if offset > size {
+		return 0, 0, io.EOF
+	}
+
+	conn := lob.rows.stmt.conn
+	byteCount := C.oraub8(len(p))
+	charCount := C.oraub8(0)
+	result := C.OCILobRead2(
+		conn.svc,              // service context handle
+		conn.errHandle,        // error handle
+		lob.locator,           // LOB or BFILE locator
+		&byteCount,            // IN - max number of bytes to read. OUT - number of bytes read
+		&charCount,            // IN - 0 so byte_amtp is used for CLOB. OUT - number of characters read
+		C.oraub8(offset),      // the 1 based offset, in bytes for BLOB and in characters for CLOB
+		unsafe.Pointer(&p[0]), // pointer to a buffer into which the piece will be read
+		C.oraub8(len(p)),      // length of the buffer
+		C.OCI_ONE_PIECE,       // read in one piece, up to the buffer length
+		nil,                   // context pointer for the callback function
+		nil,                   // callback function
+		0,                     // character set ID of the buffer data, 0 for the client's NLS_LANG or NLS_CHAR value
+		lob.form,              // character set form of the buffer data
+	)
+	if result == C.OCI_NO_DATA {
+		return 0, 0, io.EOF
+	}
+	if result != C.OCI_SUCCESS {
+		return 0, 0, conn.getError(result)
+	}
+	if byteCount == 0 {
+		return 0, 0, fmt.Errorf("lob read at offset %v returned no data", offset)
+	}
+
+	return int(byteCount), int(charCount), nil
+}
+
+// lobReadStruct is a LOB locator of the fetched batch read by readLobs
+type lobReadStruct struct {
+	column  int
+	row     int
+	locator *C.OCILobLocator
+}
+
+// readLobs reads the LOB columns of all rows of the fetched batch into lobValues.
+// The locators are read with one OCILobArrayRead call for each character set form, into the C arena of the rows.
+// A LOB that fills its part of the arena is then read to its end with ociLobReadFrom.
+func (rows *Rows) readLobs() error {
+	conn := rows.stmt.conn
+	forms := make(map[C.ub1][]lobReadStruct, 2)
+
+	for i := 0; i < len(rows.defines); i++ {
+		define := &rows.defines[i]
+		if define.dataType != C.SQLT_CLOB && define.dataType != C.SQLT_BLOB {
+			continue
+		}
+
+		if cap(rows.lobValues[i]) < rows.fetched {
+			rows.lobValues[i] = make([]driver.Value, rows.fetched)
+		}
+		rows.lobValues[i] = rows.lobValues[i][:rows.fetched]
+		indicators := (*[1 << 28]C.sb2)(unsafe.Pointer(define.indicator))[:rows.fetched:rows.fetched]
+
+		for row := 0; row < rows.fetched; row++ {
+			rows.lobValues[i][row] = nil
+			if indicators[row] != 0 {
+				// null, Next handles the indicator
+				continue
+			}
+
+			locator := *(**C.OCILobLocator)(define.value(row))
+			form := C.ub1(C.SQLCS_IMPLICIT)
+			if define.dataType == C.SQLT_CLOB {
+				// set character set form
+				result := C.OCILobCharSetForm(
+					conn.env,       // environment handle
+					conn.errHandle, // error handle
+					locator,        // LOB locator
+					&form,          // character set form
+				)
+				if result != C.OCI_SUCCESS {
+					return conn.getError(result)
+				}
+			}
+			forms[form] = append(forms[form], lobReadStruct{column: i, row: row, locator: locator})
+		}
+	}
+
+	for form, reads := range forms {
+		for start := 0; start < len(reads); start += lobArrayReadCount {
+			end := start + lobArrayReadCount
+			if end > len(reads) {
+				end = len(reads)
+			}
+			err := rows.lobArrayRead(form, reads[start:end])
+			if err != nil {
+				return err
+			}
+		}
+	}
+
+	return nil
+}
+
+// lobArrayRead reads up to lobArrayReadSize bytes of each LOB in reads with one OCILobArrayRead call,
+// then reads the rest of the LOBs that filled their buffer one by one. reads has at most lobArrayReadCount LOBs.
+// Returns errLobArrayReadUnsupported if the server does not support OCILobArrayRead.
+func (rows *Rows) lobArrayRead(form C.ub1, reads []lobReadStruct) error {
+	conn := rows.stmt.conn
+	count := len(reads)
+
+	arenaSize := count * lobArrayReadSize
+	if rows.lobArenaSize < arenaSize {
+		if rows.lobArena != nil {
+			C.free(rows.lobArena)
+		}
+		rows.lobArena = C.malloc(C.size_t(arenaSize))
+		rows.lobArenaSize = arenaSize
+	}
+
+	arrays := C.malloc(C.size_t(count) * C.size_t(2*sizeOfNilPointer+4*C.sizeof_oraub8))
+	defer C.free(arrays)
+	locators := (*[1 << 26]*C.OCILobLocator)(arrays)[:count:count]
+	buffers := (*[1 << 26]unsafe.Pointer)(unsafe.Pointer(uintptr(arrays) + uintptr(count)*sizeOfNilPointer))[:count:count]
+	amounts := (*[1 << 26]C.oraub8)(unsafe.Pointer(uintptr(arrays) + 2*uintptr(count)*sizeOfNilPointer))[: 4*count : 4*count]
+	byteAmounts := amounts[0:count:count]
+	charAmounts := amounts[count : 2*count : 2*count]
+	offsets := amounts[2*count : 3*count : 3*count]
+	bufferLengths := amounts[3*count : 4*count : 4*count]
+
+	for k := 0; k < count; k++ {
+		locators[k] = reads[k].locator
+		buffers[k] = unsafe.Pointer(uintptr(rows.lobArena) + uintptr(k*lobArrayReadSize))
+		byteAmounts[k] = lobArrayReadSize
+		charAmounts[k] = 0 // 0 so byte amounts are used for CLOB too
+		offsets[k] = 1
+		bufferLengths[k] = lobArrayReadSize
+	}
+
+	iterations := C.ub4(count)
+	result := C.OCILobArrayRead(
+		conn.svc,                       // service context handle
+		conn.errHandle,                 // error handle
+		&iterations,                    // number of LOBs in the arrays
+		&locators[0],                   // array of LOB locators
+		&byteAmounts[0],                // IN - max bytes to read for each LOB. OUT - bytes read for each LOB
+		&charAmounts[0],                // IN - 0 so byte_amt_arr is used. OUT - characters read for each CLOB
+		&offsets[0],                    // 1 based offset of each LOB, in bytes for BLOB and in characters for CLOB
+		(*unsafe.Pointer)(&buffers[0]), // array of buffers to read into
+		&bufferLengths[0],              // length of each buffer
+		C.OCI_ONE_PIECE,                // each LOB is read in one piece, up to its buffer length
+		nil,                            // context pointer for the callback function
+		nil,                            // callback function
+		0,                              // character set ID of the buffer data, 0 for the client's NLS_LANG or NLS_CHAR value
+		form,                           // character set form of the buffer data
+	)
+	if result == C.OCI_ERROR {
+		errorCode, _ := conn.ociGetError()
+		// ORA-01010: invalid OCI operation
+		// ORA-03115: unsupported network datatype or representation
+		if errorCode == 1010 || errorCode == 3115 {
+			return errLobArrayReadUnsupported
+		}
+	}
+	if result != C.OCI_SUCCESS {
+		return fmt.Errorf("LOB array read error: %v", conn.getError(result))
+	}
+
+	for k := 0; k < count; k++ {
+		read := reads[k]
+		buffer := C.GoBytes(buffers[k], C.int(byteAmounts[k]))
+
+		// a CLOB stops at a whole character, so the buffer may not be exactly full when there is more to read
+		if int(byteAmounts[k])+4 > lobArrayReadSize {
+			offset := int64(byteAmounts[k]) + 1
+			if rows.defines[read.column].dataType == C.SQLT_CLOB {
+				offset = int64(charAmounts[k]) + 1
+			}
+			var err error
+			buffer, err = conn.ociLobReadFrom(read.locator, form, offset, buffer)
+			if err != nil {
+				return err
+			}
+		}
+
+		if rows.defines[read.column].dataType == C.SQLT_BLOB {
+			rows.lobValues[read.column][read.row] = buffer
+		} else {
+			rows.lobValues[read.column][read.row] = string(buffer)
+		}
+	}
+
+	return nil
+}
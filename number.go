@@ -0,0 +1,138 @@
+package gobci
+
+import (
+	"database/sql/driver"
+	"errors"
+	"math"
+	"strconv"
+)
+
+// decodeNumber decodes an Oracle NUMBER in its internal format, the bytes of a VARNUM after the length byte.
+// Integral values that fit are returned as int64, others as an exact decimal string, for example "-123.0045".
+//
+// The first byte is the base 100 exponent, excess 65 with the sign bit, and the rest are the base 100 digits,
+// each stored plus 1 for positive numbers or as 101 minus the digit for negative numbers,
+// which also end with a byte of 102 when there is room.
+func decodeNumber(buf []byte) (driver.Value, error) {
+	if len(buf) == 0 {
+		return nil, errors.New("empty number")
+	}
+
+	exponentByte := buf[0]
+	if exponentByte == 0x80 && len(buf) == 1 {
+		return int64(0), nil
+	}
+
+	negative := exponentByte&0x80 == 0
+	var exponent int
+	digits := buf[1:]
+	if negative {
+		if exponentByte == 0 {
+			return "-Inf", nil
+		}
+		exponent = 62 - int(exponentByte)
+		if len(digits) > 0 && digits[len(digits)-1] == 102 {
+			digits = digits[:len(digits)-1]
+		}
+	} else {
+		if exponentByte == 0xff {
+			return "Inf", nil
+		}
+		exponent = int(exponentByte) - 193
+	}
+
+	// the base 100 value of each digit
+	var values [21]int
+	count := 0
+	for _, digit := range digits {
+		if count == len(values) {
+			return nil, errors.New("number has too many digits")
+		}
+		value := int(digit) - 1
+		if negative {
+			value = 101 - int(digit)
+		}
+		if value < 0 || value > 99 {
+			return nil, errors.New("invalid number digit")
+		}
+		values[count] = value
+		count++
+	}
+	// trailing zero digits do not change the value
+	for count > 0 && values[count-1] == 0 {
+		count--
+	}
+	if count == 0 {
+		return int64(0), nil
+	}
+
+	// int64 fast path: integral with at most 10 base 100 digits before the point.
+	// 10 digits can be up to 20 decimal digits, so values that overflow uint64 go to the decimal string.
+	if count <= exponent+1 && exponent < 10 {
+		var unsigned uint64
+		overflow := false
+		for i := 0; i <= exponent; i++ {
+			digit := 0
+			if i < count {
+				digit = values[i]
+			}
+			if unsigned > (math.MaxUint64-uint64(digit))/100 {
+				overflow = true
+				break
+			}
+			unsigned = unsigned*100 + uint64(digit)
+		}
+		if !overflow && !negative && unsigned <= math.MaxInt64 {
+			return int64(unsigned), nil
+		}
+		if !overflow && negative && unsigned <= math.MaxInt64+1 {
+			return -int64(unsigned-1) - 1, nil
+		}
+	}
+
+	// exact decimal string
+	result := make([]byte, 0, 2*count+8)
+	if negative {
+		result = append(result, '-')
+	}
+
+	if exponent < 0 {
+		result = append(result, '0', '.')
+		for i := exponent + 1; i < 0; i++ {
+			result = append(result, '0', '0')
+		}
+		for i := 0; i < count; i++ {
+			result = append(result, byte('0'+values[i]/10), byte('0'+values[i]%10))
+		}
+		return string(trimFractionZeros(result)), nil
+	}
+
+	for i := 0; i <= exponent; i++ {
+		digit := 0
+		if i < count {
+			digit = values[i]
+		}
+		if i == 0 {
+			result = strconv.AppendInt(result, int64(digit), 10)
+		} else {
+			result = append(result, byte('0'+digit/10), byte('0'+digit%10))
+		}
+	}
+	if count > exponent+1 {
+		result = append(result, '.')
+		for i := exponent + 1; i < count; i++ {
+			result = append(result, byte('0'+values[i]/10), byte('0'+values[i]%10))
+		}
+		result = trimFractionZeros(result)
+	}
+
+	return string(result), nil
+}
+
+// trimFractionZeros removes the trailing zeros of a decimal with a fraction
+func trimFractionZeros(result []byte) []byte {
+	for len(result) > 0 && result[len(result)-1] == '0' {
+		result = result[:len(result)-1]
+	}
+	return result
+}
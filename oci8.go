@@ -9,7 +9,6 @@ import (
 	"fmt"
 	"io/ioutil"
 	"log"
-	"os"
 	"strconv"
 	"strings"
 	"time"
@@ -34,8 +33,51 @@ import (
 // prefetch_rows - the number of top level rows to be prefetched. Defaults to 0. A 0 means unlimited rows.
 //
 // prefetch_memory - the max memory for top level rows to be prefetched. Defaults to 4096. A 0 means unlimited memory.
+// Both can be overridden per query with WithPrefetch.
+//
+// prefetch_budget - when set, prefetch is adaptive: the number of rows prefetched is computed from the width of the
+// described row so a round trip uses at most this many bytes. It starts small and doubles as the rows are fetched,
+// so key lookups stay cheap and large exports get large round trips. Defaults to 0, not adaptive.
+// Can be overridden per query with WithAdaptivePrefetch.
+//
+// fetch_array_size - the number of rows fetched into the define buffers by each fetch call. Defaults to 1. Max 16777216.
+// Can be overridden per query with WithFetchArraySize.
+//
+// lob_prefetch_size - the number of bytes of CLOB and BLOB data prefetched with the locator of each row,
+// so small LOBs are read without another round trip. Defaults to 0, no LOB prefetch.
+// Can be overridden per query with WithLobPrefetchSize.
+//
+// lob_inline_size - when set, CLOB and BLOB columns are defined as long string and raw buffers of this many bytes
+// and come back inline with the row. A value larger than the buffer is an error. Max 32767. Defaults to 0, not inline.
+// Can be overridden per query with WithLobInlineSize.
+//
+// pool - when set to session, connections get and release sessions of a shared OCI session pool
+// instead of attaching to the server and beginning a session each time. Defaults to no session pool.
+//
+// pool_min, pool_max, pool_incr - the minimum, maximum, and increment number of sessions of the session pool.
+// Defaults to 1, 100, and 1.
+//
+// stmt_cache_size - the size of the OCI statement cache. Defaults to 0, no statement cache.
+// With a session pool, sessions are checked out with their statement cache.
 //
 // questionph - when true, enables question mark placeholders. Defaults to false. (uses strconv.ParseBool to check for true)
+//
+// exact_numbers - when true, NUMBER columns with a fraction or more than 18 digits are returned exactly,
+// as int64 when the value is integral and fits, otherwise as a decimal string, instead of as float64.
+// Defaults to false. (uses strconv.ParseBool to check for true)
+//
+// date_binds - when true, time.Time values without fractional seconds are bound in the 7 byte DATE format,
+// in the time location of the connection, instead of as a TIMESTAMP WITH TIME ZONE descriptor.
+// The time zone is not sent, so only use it when the binds target DATE and TIMESTAMP columns.
+// Defaults to false. (uses strconv.ParseBool to check for true)
+//
+// objects - when true, the OCI environment is created in object mode, which is needed by NewQueue.
+// Defaults to false. (uses strconv.ParseBool to check for true)
+//
+// events - when true, the OCI environment is created in events and object mode, which is needed by NewSubscription.
+// Defaults to false. (uses strconv.ParseBool to check for true)
+//
+// Connections share an OCI environment only with connections opened with the same objects and events settings.
 func ParseDSN(dsnString string) (dsn *DSN, err error) {
 
 	if dsnString == "" {
@@ -51,7 +93,11 @@ func ParseDSN(dsnString string) (dsn *DSN, err error) {
 	dsn = &DSN{
 		prefetchRows:   0,
 		prefetchMemory: 4096,
+		fetchArraySize: 1,
 		stmtCacheSize:  0,
+		poolMin:        1,
+		poolMax:        100,
+		poolIncr:       1,
 		operationMode:  C.OCI_DEFAULT,
 		timeLocation:   time.UTC,
 	}
@@ -97,6 +143,33 @@ func ParseDSN(dsnString string) (dsn *DSN, err error) {
 			if err != nil {
 				return nil, fmt.Errorf("Invalid questionph: %v", v[0])
 			}
+		case "exact_numbers":
+			dsn.exactNumbers, err = strconv.ParseBool(v[0])
+			if err != nil {
+				return nil, fmt.Errorf("Invalid exact_numbers: %v", v[0])
+			}
+		case "date_binds":
+			dsn.dateBinds, err = strconv.ParseBool(v[0])
+			if err != nil {
+				return nil, fmt.Errorf("Invalid date_binds: %v", v[0])
+			}
+		case "objects":
+			objects, err := strconv.ParseBool(v[0])
+			if err != nil {
+				return nil, fmt.Errorf("Invalid objects: %v", v[0])
+			}
+			if objects {
+				dsn.environmentMode |= C.OCI_OBJECT
+			}
+		case "events":
+			events, err := strconv.ParseBool(v[0])
+			if err != nil {
+				return nil, fmt.Errorf("Invalid events: %v", v[0])
+			}
+			if events {
+				// change descriptors of events are objects
+				dsn.environmentMode |= C.OCI_EVENTS | C.OCI_OBJECT
+			}
 		case "prefetch_rows":
 			z, err := strconv.ParseUint(v[0], 10, 32)
 			if err != nil {
@@ -109,6 +182,30 @@ func ParseDSN(dsnString string) (dsn *DSN, err error) {
 				return nil, fmt.Errorf("invalid prefetch_memory: %v", v[0])
 			}
 			dsn.prefetchMemory = C.ub4(z)
+		case "prefetch_budget":
+			z, err := strconv.ParseUint(v[0], 10, 31)
+			if err != nil {
+				return nil, fmt.Errorf("invalid prefetch_budget: %v", v[0])
+			}
+			dsn.prefetchBudget = int(z)
+		case "fetch_array_size":
+			z, err := strconv.ParseUint(v[0], 10, 32)
+			if err != nil || z < 1 || z > maxArraySize {
+				return nil, fmt.Errorf("invalid fetch_array_size: %v", v[0])
+			}
+			dsn.fetchArraySize = int(z)
+		case "lob_prefetch_size":
+			z, err := strconv.ParseUint(v[0], 10, 32)
+			if err != nil {
+				return nil, fmt.Errorf("invalid lob_prefetch_size: %v", v[0])
+			}
+			dsn.lobPrefetchSize = int(z)
+		case "lob_inline_size":
+			z, err := strconv.ParseUint(v[0], 10, 32)
+			if err != nil || z > 32767 {
+				return nil, fmt.Errorf("invalid lob_inline_size: %v", v[0])
+			}
+			dsn.lobInlineSize = int(z)
 		case "as":
 			switch v[0] {
 			case "SYSDBA", "sysdba":
@@ -126,9 +223,43 @@ func ParseDSN(dsnString string) (dsn *DSN, err error) {
 				return nil, fmt.Errorf("invalid stmt_cache_size: %v", v[0])
 			}
 			dsn.stmtCacheSize = C.ub4(z)
+		case "pool":
+			switch v[0] {
+			case "session":
+				dsn.sessionPool = true
+			case "", "none":
+				dsn.sessionPool = false
+			default:
+				return nil, fmt.Errorf("invalid pool: %v", v[0])
+			}
+		case "pool_min":
+			z, err := strconv.ParseUint(v[0], 10, 32)
+			if err != nil {
+				return nil, fmt.Errorf("invalid pool_min: %v", v[0])
+			}
+			dsn.poolMin = C.ub4(z)
+		case "pool_max":
+			z, err := strconv.ParseUint(v[0], 10, 32)
+			if err != nil || z < 1 {
+				return nil, fmt.Errorf("invalid pool_max: %v", v[0])
+			}
+			dsn.poolMax = C.ub4(z)
+		case "pool_incr":
+			z, err := strconv.ParseUint(v[0], 10, 32)
+			if err != nil || z < 1 {
+				return nil, fmt.Errorf("invalid pool_incr: %v", v[0])
+			}
+			dsn.poolIncr = C.ub4(z)
 		}
 	}
 
+	if dsn.sessionPool && dsn.operationMode != C.OCI_DEFAULT {
+		return nil, errors.New("as is not supported with pool=session")
+	}
+	if dsn.poolMin > dsn.poolMax {
+		return nil, fmt.Errorf("pool_min %v is greater than pool_max %v", dsn.poolMin, dsn.poolMax)
+	}
+
 	return dsn, nil
 }
 
@@ -160,47 +291,40 @@ func (tx *Tx) Rollback() error {
 
 // Open opens a new database connection
 func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
-	var err error
-	var dsn *DSN
-	if dsn, err = ParseDSN(dsnString); err != nil {
+	dsn, err := ParseDSN(dsnString)
+	if err != nil {
 		return nil, err
 	}
 
+	conn, err := openConn(dsn, drv.Logger)
+	if err != nil {
+		return nil, err
+	}
+
+	return conn, nil
+}
+
+// openConn opens a new database connection using a parsed DSN
+func openConn(dsn *DSN, logger *log.Logger) (*Conn, error) {
+	var err error
+
 	conn := Conn{
 		operationMode: dsn.operationMode,
 		stmtCacheSize: dsn.stmtCacheSize,
-		logger:        drv.Logger,
+		logger:        logger,
 	}
 	if conn.logger == nil {
 		conn.logger = log.New(ioutil.Discard, "", 0)
 	}
 
-	// environment handle
-	var envP *C.OCIEnv
-	envPP := &envP
-	var result C.sword
-	charset := C.ub2(0)
-
-	if os.Getenv("NLS_LANG") == "" && os.Getenv("NLS_NCHAR") == "" {
-		charset = defaultCharset
+	// environment handle, shared by all connections with the same NLS settings and environment mode
+	conn.environment, err = getEnvironment(dsn.environmentMode)
+	if err != nil {
+		return nil, err
 	}
+	conn.env = conn.environment.env
 
-	result = C.OCIEnvNlsCreate(
-		envPP,          // pointer to a handle to the environment
-		C.OCI_THREADED, // environment mode: https://docs.oracle.com/cd/B28359_01/appdev.111/b28395/oci16rel001.htm#LNOCI87683
-		nil,            // Specifies the user-defined context for the memory callback routines.
-		nil,            // Specifies the user-defined memory allocation function. If mode is OCI_THREADED, this memory allocation routine must be thread-safe.
-		nil,            // Specifies the user-defined memory re-allocation function. If the mode is OCI_THREADED, this memory allocation routine must be thread safe.
-		nil,            // Specifies the user-defined memory free function. If mode is OCI_THREADED, this memory free routine must be thread-safe.
-		0,              // Specifies the amount of user memory to be allocated for the duration of the environment.
-		nil,            // Returns a pointer to the user memory of size xtramemsz allocated by the call for the user.
-		charset,        // The client-side character set for the current environment handle. If it is 0, the NLS_LANG setting is used.
-		charset,        // The client-side national character set for the current environment handle. If it is 0, NLS_NCHAR setting is used.
-	)
-	if result != C.OCI_SUCCESS {
-		return nil, errors.New("OCIEnvNlsCreate error")
-	}
-	conn.env = *envPP
+	var result C.sword
 
 	// defer on error handle free
 	var doneSessionBegin bool
@@ -208,6 +332,10 @@ func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
 	var doneLogon bool
 	defer func(errP *error) {
 		if *errP != nil {
+			if conn.sessionPool != nil {
+				conn.badConnection = true
+				conn.sessionRelease()
+			}
 			if doneSessionBegin {
 				C.OCISessionEnd(
 					conn.svc,
@@ -230,7 +358,7 @@ func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
 				)
 			}
 			if conn.txHandle != nil {
-				C.OCIHandleFree(unsafe.Pointer(conn.txHandle), C.OCI_HTYPE_TRANS)
+				conn.environment.handlePut(C.OCI_HTYPE_TRANS, unsafe.Pointer(conn.txHandle))
 				conn.txHandle = nil
 			}
 			if conn.usrSession != nil {
@@ -246,29 +374,21 @@ func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
 				conn.srv = nil
 			}
 			if conn.errHandle != nil {
-				C.OCIHandleFree(unsafe.Pointer(conn.errHandle), C.OCI_HTYPE_ERROR)
+				conn.environment.handlePut(C.OCI_HTYPE_ERROR, unsafe.Pointer(conn.errHandle))
 				conn.errHandle = nil
 			}
-			C.OCIHandleFree(unsafe.Pointer(conn.env), C.OCI_HTYPE_ENV)
 		}
 	}(&err)
 
 	// error handle
-	var handleTemp unsafe.Pointer
-	handle := &handleTemp
-	result = C.OCIHandleAlloc(
-		unsafe.Pointer(conn.env), // An environment handle
-		handle,                   // Returns a handle
-		C.OCI_HTYPE_ERROR,        // type of handle: https://docs.oracle.com/cd/B28359_01/appdev.111/b28395/oci02bas.htm#LNOCI87581
-		0,                        // amount of user memory to be allocated
-		nil,                      // Returns a pointer to the user memory
-	)
-	if result != C.OCI_SUCCESS {
+	var errHandle unsafe.Pointer
+	errHandle, err = conn.environment.handleGet(C.OCI_HTYPE_ERROR)
+	if err != nil {
 		// TODO: error handle not yet allocated, how to get string error from oracle?
 		err = errors.New("allocate error handle error")
 		return nil, err
 	}
-	conn.errHandle = (*C.OCIError)(*handle)
+	conn.errHandle = (*C.OCIError)(errHandle)
 
 	connectString := cString(dsn.Connect)
 	defer C.free(unsafe.Pointer(connectString))
@@ -277,7 +397,15 @@ func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
 	password := cString(dsn.Password)
 	defer C.free(unsafe.Pointer(password))
 
-	if useOCISessionBegin {
+	if dsn.sessionPool {
+		err = conn.sessionGet(dsn)
+		if err != nil {
+			return nil, err
+		}
+
+	} else if useOCISessionBegin {
+		var handle *unsafe.Pointer
+
 		// server handle
 		handle, _, err = conn.ociHandleAlloc(C.OCI_HTYPE_SERVER, 0)
 		if err != nil {
@@ -396,14 +524,15 @@ func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
 	}
 
 	// Create transaction context.
-	handle, _, err = conn.ociHandleAlloc(C.OCI_HTYPE_TRANS, 0)
+	var txHandle unsafe.Pointer
+	txHandle, err = conn.environment.handleGet(C.OCI_HTYPE_TRANS)
 	if err != nil {
 		return nil, fmt.Errorf("allocate transaction handle error: %v", err)
 	}
-	conn.txHandle = (*C.OCITrans)(*handle)
+	conn.txHandle = (*C.OCITrans)(txHandle)
 
 	// Set transaction context attribute of the service context.
-	err = conn.ociAttrSet(unsafe.Pointer(conn.svc), C.OCI_HTYPE_SVCCTX, *handle, 0, C.OCI_ATTR_TRANS)
+	err = conn.ociAttrSet(unsafe.Pointer(conn.svc), C.OCI_HTYPE_SVCCTX, txHandle, 0, C.OCI_ATTR_TRANS)
 	if err != nil {
 		return nil, fmt.Errorf("service context attribute set error: %v", err)
 	}
@@ -411,8 +540,14 @@ func (drv *DriverStruct) Open(dsnString string) (driver.Conn, error) {
 	conn.transactionMode = dsn.transactionMode
 	conn.prefetchRows = dsn.prefetchRows
 	conn.prefetchMemory = dsn.prefetchMemory
+	conn.prefetchBudget = dsn.prefetchBudget
+	conn.fetchArraySize = dsn.fetchArraySize
+	conn.lobPrefetchSize = dsn.lobPrefetchSize
+	conn.lobInlineSize = dsn.lobInlineSize
 	conn.timeLocation = dsn.timeLocation
 	conn.enableQMPlaceholders = dsn.enableQMPlaceholders
+	conn.exactNumbers = dsn.exactNumbers
+	conn.dateBinds = dsn.dateBinds
 
 	return &conn, nil
 }
@@ -441,8 +576,15 @@ func placeholders(sql string) string {
 	})
 }
 
+// timezoneToLocation returns the location of a time zone offset.
+// Whole hours from -12 to 14 use timeLocations, other offsets a fixed zone cached by offset.
 func timezoneToLocation(hour int64, minute int64) *time.Location {
 	if minute != 0 || hour > 14 || hour < -12 {
+		offset := (3600 * int(hour)) + (60 * int(minute))
+		if location, ok := offsetLocations.Load(offset); ok {
+			return location.(*time.Location)
+		}
+
 		// create location with FixedZone
 		var name string
 		if hour < 0 {
@@ -458,9 +600,25 @@ func timezoneToLocation(hour int64, minute int64) *time.Location {
 			}
 			name += strconv.FormatInt(minute, 10)
 		}
-		return time.FixedZone(name, (3600*int(hour))+(60*int(minute)))
+		location, _ := offsetLocations.LoadOrStore(offset, time.FixedZone(name, offset))
+		return location.(*time.Location)
 	}
 
 	// use location from timeLocations cache
 	return timeLocations[12+hour]
 }
+
+// regionToLocation returns the location of an Oracle time zone region name, cached by name.
+// Returns nil if Go does not know the region, then the offset is used.
+func regionToLocation(name []byte) *time.Location {
+	if location, ok := regionLocations.Load(string(name)); ok {
+		return location.(*time.Location)
+	}
+
+	location, err := time.LoadLocation(string(name))
+	if err != nil {
+		location = nil
+	}
+	regionLocations.Store(string(name), location)
+	return location
+}
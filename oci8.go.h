@@ -1,2 +1,545 @@
+#ifndef OCI8_GO_H
+#define OCI8_GO_H
+
 #include <oci.h>
+#include <ocijson.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// OCI8_GO_NO_MEMORY is returned by the helpers below when they can not allocate their scratch memory
+#define OCI8_GO_NO_MEMORY (-1000)
+
+// ociDateTimeFields are the fields of an OCIDateTime returned by ociDateTimeGetFields
+typedef struct {
+	sb2 year;
+	ub1 month;
+	ub1 day;
+	ub1 hour;
+	ub1 minute;
+	ub1 second;
+	ub4 fsec;
+	sb1 timeZoneHour;
+	sb1 timeZoneMinute;
+	ub4 timeZoneNameLength;
+	ub1 timeZoneName[64];
+} ociDateTimeFields;
+
+// ociDateTimeGetFields gets the date and time of dateTime and, when withTimeZone is set,
+// its time zone offset and name, so decoding a value is one cgo call.
+// The name is the region name, or [+|-]HH:MM when the value has no region. Its length is 0 if it could not be read.
+static sword ociDateTimeGetFields(void *env, OCIError *errHandle, OCIDateTime *dateTime, int withTimeZone, ociDateTimeFields *fields) {
+	sword result = OCIDateTimeGetDate(env, errHandle, dateTime, &fields->year, &fields->month, &fields->day);
+	if (result != OCI_SUCCESS) {
+		return result;
+	}
+
+	result = OCIDateTimeGetTime(env, errHandle, dateTime, &fields->hour, &fields->minute, &fields->second, &fields->fsec);
+	if (result != OCI_SUCCESS || !withTimeZone) {
+		return result;
+	}
+
+	result = OCIDateTimeGetTimeZoneOffset(env, errHandle, dateTime, &fields->timeZoneHour, &fields->timeZoneMinute);
+	if (result != OCI_SUCCESS) {
+		return result;
+	}
+
+	fields->timeZoneNameLength = sizeof(fields->timeZoneName);
+	if (OCIDateTimeGetTimeZoneName(env, errHandle, dateTime, fields->timeZoneName, &fields->timeZoneNameLength) != OCI_SUCCESS) {
+		fields->timeZoneNameLength = 0;
+	}
+
+	return OCI_SUCCESS;
+}
+
+// ociDirPathColArraySet sets the entries of rows rows of a direct path column array from C arrays of values,
+// lengths, and flags in row major order, so a batch of rows is set with one cgo call
+static sword ociDirPathColArraySet(OCIDirPathColArray *columnArray, OCIError *errHandle, ub4 rows, ub2 columns, ub1 **values, ub4 *lengths, ub1 *flags) {
+	ub4 row;
+	ub2 column;
+	sword result;
+	for (row = 0; row < rows; row++) {
+		for (column = 0; column < columns; column++) {
+			ub4 i = row * columns + column;
+			result = OCIDirPathColArrayEntrySet(columnArray, errHandle, row, column, values[i], lengths[i], flags[i]);
+			if (result != OCI_SUCCESS) {
+				return result;
+			}
+		}
+	}
+	return OCI_SUCCESS;
+}
+
+// ociAQRawType gets the type descriptor of RAW queue payloads
+static sword ociAQRawType(OCIEnv *env, OCIError *errHandle, OCISvcCtx *svc, OCIType **tdo) {
+	return OCITypeByName(env, errHandle, svc, (const oratext *)"SYS", 3, (const oratext *)"RAW", 3, NULL, 0, OCI_DURATION_SESSION, OCI_TYPEGET_HEADER, tdo);
+}
+
+// ociAQEnqArray calls OCIAQEnqArray with RAW payloads, taking void pointers so OCIRaw is not needed in Go
+static sword ociAQEnqArray(OCISvcCtx *svc, OCIError *errHandle, OraText *queueName, void *options, ub4 *iters, void **properties, OCIType *payloadType, void **payloads, void **indicators, void **ids) {
+	return OCIAQEnqArray(svc, errHandle, queueName, (OCIAQEnqOptions *)options, iters, (OCIAQMsgProperties **)properties, payloadType, payloads, indicators, (OCIRaw **)ids, NULL, NULL, OCI_DEFAULT);
+}
+
+// ociAQDeqArray calls OCIAQDeqArray with RAW payloads, taking void pointers so OCIRaw is not needed in Go
+static sword ociAQDeqArray(OCISvcCtx *svc, OCIError *errHandle, OraText *queueName, void *options, ub4 *iters, void **properties, OCIType *payloadType, void **payloads, void **indicators, void **ids) {
+	return OCIAQDeqArray(svc, errHandle, queueName, (OCIAQDeqOptions *)options, iters, (OCIAQMsgProperties **)properties, payloadType, payloads, indicators, (OCIRaw **)ids, NULL, NULL, OCI_DEFAULT);
+}
+
+// ociAQMessageFields are the payload, id, and properties of a queue message
+typedef struct {
+	ub1 *payload;
+	ub4 payloadLength;
+	ub1 *id;
+	ub4 idLength;
+	sb4 priority;
+	sb4 delay;
+	sb4 expiration;
+	sb4 attempts;
+	oratext *correlation;
+	ub4 correlationLength;
+	sb2 enqueueYear;
+	ub1 enqueueMonth;
+	ub1 enqueueDay;
+	ub1 enqueueHour;
+	ub1 enqueueMinute;
+	ub1 enqueueSecond;
+} ociAQMessageFields;
+
+// ociAQMessagesSet sets the RAW payloads and the properties of count messages to enqueue, so a batch is one cgo call.
+// Payloads that are NULL are allocated, others are resized.
+static sword ociAQMessagesSet(OCIEnv *env, OCIError *errHandle, ub4 count, void **properties, void **payloads, ociAQMessageFields *fields) {
+	ub4 i;
+	sword result;
+	for (i = 0; i < count; i++) {
+		result = OCIRawAssignBytes(env, errHandle, fields[i].payload, fields[i].payloadLength, (OCIRaw **)&payloads[i]);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrSet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].priority, 0, OCI_ATTR_PRIORITY, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrSet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].delay, 0, OCI_ATTR_DELAY, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrSet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].expiration, 0, OCI_ATTR_EXPIRATION, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrSet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, fields[i].correlation, fields[i].correlationLength, OCI_ATTR_CORRELATION, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+	}
+	return OCI_SUCCESS;
+}
+
+// ociAQMessagesGet gets the ids of count messages and, when withPayloads is set, their RAW payloads and properties.
+// The payload, id, and correlation pointers point into OCI memory and are valid until the next enqueue or dequeue.
+static sword ociAQMessagesGet(OCIEnv *env, OCIError *errHandle, ub4 count, void **properties, void **payloads, void **ids, int withPayloads, ociAQMessageFields *fields) {
+	ub4 i;
+	sword result;
+	OCIDate enqueueTime;
+	for (i = 0; i < count; i++) {
+		fields[i].id = NULL;
+		fields[i].idLength = 0;
+		if (ids[i] != NULL) {
+			fields[i].id = OCIRawPtr(env, ids[i]);
+			fields[i].idLength = OCIRawSize(env, ids[i]);
+		}
+		if (!withPayloads) {
+			continue;
+		}
+
+		fields[i].payload = NULL;
+		fields[i].payloadLength = 0;
+		if (payloads[i] != NULL) {
+			fields[i].payload = OCIRawPtr(env, payloads[i]);
+			fields[i].payloadLength = OCIRawSize(env, payloads[i]);
+		}
+		result = OCIAttrGet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].priority, NULL, OCI_ATTR_PRIORITY, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrGet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].delay, NULL, OCI_ATTR_DELAY, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrGet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].expiration, NULL, OCI_ATTR_EXPIRATION, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrGet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].attempts, NULL, OCI_ATTR_ATTEMPTS, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		fields[i].correlation = NULL;
+		fields[i].correlationLength = 0;
+		result = OCIAttrGet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &fields[i].correlation, &fields[i].correlationLength, OCI_ATTR_CORRELATION, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		result = OCIAttrGet(properties[i], OCI_DTYPE_AQMSG_PROPERTIES, &enqueueTime, NULL, OCI_ATTR_ENQ_TIME, errHandle);
+		if (result != OCI_SUCCESS) {
+			return result;
+		}
+		fields[i].enqueueYear = enqueueTime.OCIDateYYYY;
+		fields[i].enqueueMonth = enqueueTime.OCIDateMM;
+		fields[i].enqueueDay = enqueueTime.OCIDateDD;
+		fields[i].enqueueHour = enqueueTime.OCIDateTime.OCITimeHH;
+		fields[i].enqueueMinute = enqueueTime.OCIDateTime.OCITimeMI;
+		fields[i].enqueueSecond = enqueueTime.OCIDateTime.OCITimeSS;
+	}
+	return OCI_SUCCESS;
+}
+
+// ociRawArrayFree frees the raws of a raw array that are not NULL and sets them to NULL
+static void ociRawArrayFree(OCIEnv *env, OCIError *errHandle, ub4 count, void **raws) {
+	ub4 i;
+	for (i = 0; i < count; i++) {
+		if (raws[i] != NULL) {
+			OCIRawResize(env, errHandle, 0, (OCIRaw **)&raws[i]);
+			raws[i] = NULL;
+		}
+	}
+}
+
+// gobciSubscriptionNotify is exported by subscription.go
+extern void gobciSubscriptionNotify(uintptr_t id, void *descriptor);
+
+// ociSubscriptionNotify is the notification callback of subscriptions. It runs on an OCI thread
+// and hands the change descriptor to Go, the context is the id of the subscription.
+static ub4 ociSubscriptionNotify(void *context, OCISubscription *subscription, void *payload, ub4 payloadLength, void *descriptor, ub4 mode) {
+	gobciSubscriptionNotify((uintptr_t)context, descriptor);
+	return OCI_CONTINUE;
+}
+
+// ociSubscriptionSetCallback sets ociSubscriptionNotify as the callback of a subscription with the subscription id as context
+static sword ociSubscriptionSetCallback(OCISubscription *subscription, OCIError *errHandle, uintptr_t id) {
+	sword result = OCIAttrSet(subscription, OCI_HTYPE_SUBSCRIPTION, (void *)ociSubscriptionNotify, 0, OCI_ATTR_SUBSCR_CALLBACK, errHandle);
+	if (result != OCI_SUCCESS) {
+		return result;
+	}
+	return OCIAttrSet(subscription, OCI_HTYPE_SUBSCRIPTION, (void *)id, 0, OCI_ATTR_SUBSCR_CTX, errHandle);
+}
+
+// ociCollDescriptorCount returns the number of descriptors in a collection of change descriptors, 0 if it is NULL
+static sb4 ociCollDescriptorCount(OCIEnv *env, OCIError *errHandle, void *collection) {
+	sb4 size = 0;
+	if (collection == NULL || OCICollSize(env, errHandle, (OCIColl *)collection, &size) != OCI_SUCCESS) {
+		return 0;
+	}
+	return size;
+}
+
+// ociCollDescriptor returns the descriptor at index of a collection of change descriptors, NULL if there is none
+static void *ociCollDescriptor(OCIEnv *env, OCIError *errHandle, void *collection, sb4 index) {
+	boolean exists = 0;
+	void **element = NULL;
+	void *indicator = NULL;
+	if (OCICollGetElem(env, errHandle, (OCIColl *)collection, index, &exists, (void **)&element, &indicator) != OCI_SUCCESS || !exists || element == NULL) {
+		return NULL;
+	}
+	return *element;
+}
+
+// ociXStreamOutReceive receives up to max LCRs of the current XStream Out call into lcrs, types and flags.
+// It stops early after an LCR that has more chunk data, so the chunks can be received before the next LCR.
+// OCI_STILL_EXECUTING means the call is still streaming, OCI_SUCCESS means the call completed
+// and the fetch low position was returned in lowPosition.
+static sword ociXStreamOutReceive(OCISvcCtx *svc, OCIError *errHandle, ub4 max, void **lcrs, ub1 *types, oraub8 *flags, ub4 *count, ub1 *lowPosition, ub2 *lowPositionLength) {
+	sword result = OCI_STILL_EXECUTING;
+	*count = 0;
+	*lowPositionLength = 0;
+	while (*count < max) {
+		lcrs[*count] = NULL;
+		flags[*count] = 0;
+		result = OCIXStreamOutLCRReceive(svc, errHandle, &lcrs[*count], &types[*count], &flags[*count], lowPosition, lowPositionLength, OCI_DEFAULT);
+		if (result != OCI_STILL_EXECUTING) {
+			return result;
+		}
+		(*count)++;
+		if (flags[*count - 1] & OCI_XSTREAM_MORE_ROW_DATA) {
+			break;
+		}
+	}
+	return result;
+}
+
+// ociLCRHeader is the header of an LCR returned by ociLCRsRead, the pointers point into the LCR.
+// The old and new columns of a row LCR are at start for count in the column array.
+typedef struct {
+	oratext *sourceDatabase;
+	ub2 sourceDatabaseLength;
+	oratext *command;
+	ub2 commandLength;
+	oratext *owner;
+	ub2 ownerLength;
+	oratext *object;
+	ub2 objectLength;
+	ub1 *tag;
+	ub2 tagLength;
+	oratext *transactionID;
+	ub2 transactionIDLength;
+	ub1 *position;
+	ub2 positionLength;
+	oraub8 flags;
+	sb2 sourceYear;
+	ub1 sourceMonth;
+	ub1 sourceDay;
+	ub1 sourceHour;
+	ub1 sourceMinute;
+	ub1 sourceSecond;
+	ub4 oldStart;
+	ub2 oldCount;
+	ub4 newStart;
+	ub2 newCount;
+} ociLCRHeader;
+
+// ociLCRColumn is a column value of a row LCR, the pointers point into the LCR.
+// Date and timestamp values are read into dateTime and interval values into text.
+typedef struct {
+	oratext *name;
+	ub2 nameLength;
+	ub2 dataType;
+	void *value;
+	ub2 length;
+	OCIInd indicator;
+	ub1 charsetForm;
+	oraub8 flags;
+	ociDateTimeFields dateTime;
+	size_t textLength;
+	oratext text[64];
+} ociLCRColumn;
+
+// ociLCRColumnsRead reads the OLD or NEW column values of a row LCR into columns, at most capacity of them
+static sword ociLCRColumnsRead(OCISvcCtx *svc, OCIError *errHandle, void *env, void *lcr, ub2 valueType, ociLCRColumn *columns, ub2 capacity, ub2 *count,
+	oratext **names, ub2 *nameLengths, ub2 *dataTypes, void **values, OCIInd *indicators, ub2 *lengths, ub1 *charsetForms, oraub8 *flags, ub2 *charsetIDs) {
+	ub2 i;
+	sword result;
+	*count = 0;
+	if (capacity == 0) {
+		return OCI_SUCCESS;
+	}
+	// OCILCR_NEW_ONLY_MODE is only valid for the NEW column list, it keeps OLD only columns out of it
+	result = OCILCRRowColumnInfoGet(svc, errHandle, valueType, count, names, nameLengths, dataTypes, values, indicators, lengths, charsetForms, flags, charsetIDs, lcr, capacity,
+		valueType == OCI_LCR_ROW_COLVAL_NEW ? OCILCR_NEW_ONLY_MODE : OCI_DEFAULT);
+	if (result != OCI_SUCCESS) {
+		return result;
+	}
+	for (i = 0; i < *count; i++) {
+		ociLCRColumn *column = &columns[i];
+		column->name = names[i];
+		column->nameLength = nameLengths[i];
+		column->dataType = dataTypes[i];
+		column->value = values[i];
+		column->length = lengths[i];
+		column->indicator = indicators[i];
+		column->charsetForm = charsetForms[i];
+		column->flags = flags[i];
+		column->textLength = 0;
+		if (column->indicator == OCI_IND_NULL || column->value == NULL) {
+			continue;
+		}
+		switch (column->dataType) {
+		case SQLT_ODT: {
+			OCIDate *date = (OCIDate *)column->value;
+			column->dateTime.year = date->OCIDateYYYY;
+			column->dateTime.month = date->OCIDateMM;
+			column->dateTime.day = date->OCIDateDD;
+			column->dateTime.hour = date->OCIDateTime.OCITimeHH;
+			column->dateTime.minute = date->OCIDateTime.OCITimeMI;
+			column->dateTime.second = date->OCIDateTime.OCITimeSS;
+			column->dateTime.fsec = 0;
+			break;
+		}
+		case SQLT_TIMESTAMP:
+		case SQLT_TIMESTAMP_TZ:
+		case SQLT_TIMESTAMP_LTZ:
+			result = ociDateTimeGetFields(env, errHandle, (OCIDateTime *)column->value, column->dataType != SQLT_TIMESTAMP, &column->dateTime);
+			if (result != OCI_SUCCESS) {
+				return result;
+			}
+			break;
+		case SQLT_INTERVAL_YM:
+		case SQLT_INTERVAL_DS:
+			result = OCIIntervalToText(env, errHandle, (OCIInterval *)column->value, 9, 9, column->text, sizeof(column->text), &column->textLength);
+			if (result != OCI_SUCCESS) {
+				return result;
+			}
+			break;
+		}
+	}
+	return OCI_SUCCESS;
+}
+
+// ociLCRsRead reads the headers and, for row LCRs, the column values of count LCRs in one cgo call.
+// Reading stops before an LCR whose columns do not fit in the remaining column capacity,
+// read is the number of LCRs read and needed the number of columns of the LCR that did not fit.
+static sword ociLCRsRead(OCISvcCtx *svc, OCIError *errHandle, void *env, ub4 count, void **lcrs, ub1 *types,
+	ociLCRHeader *headers, ociLCRColumn *columns, ub4 columnCapacity, ub4 *read, ub4 *needed) {
+	ub4 i;
+	ub4 used = 0;
+	ub2 oldColumns;
+	ub2 newColumns;
+	OCIDate sourceTime;
+	sword result = OCI_SUCCESS;
+	size_t scratchSize = columnCapacity > 65535 ? 65535 : columnCapacity;
+	oratext **names = malloc(scratchSize * sizeof(oratext *));
+	ub2 *nameLengths = malloc(scratchSize * sizeof(ub2));
+	ub2 *dataTypes = malloc(scratchSize * sizeof(ub2));
+	void **values = malloc(scratchSize * sizeof(void *));
+	OCIInd *indicators = malloc(scratchSize * sizeof(OCIInd));
+	ub2 *lengths = malloc(scratchSize * sizeof(ub2));
+	ub1 *charsetForms = malloc(scratchSize * sizeof(ub1));
+	oraub8 *flags = malloc(scratchSize * sizeof(oraub8));
+	ub2 *charsetIDs = malloc(scratchSize * sizeof(ub2));
+
+	*read = 0;
+	*needed = 0;
+	if (names == NULL || nameLengths == NULL || dataTypes == NULL || values == NULL || indicators == NULL ||
+		lengths == NULL || charsetForms == NULL || flags == NULL || charsetIDs == NULL) {
+		count = 0;
+		result = OCI8_GO_NO_MEMORY;
+	}
+	for (i = 0; i < count; i++) {
+		ociLCRHeader *header = &headers[i];
+		memset(header, 0, sizeof(ociLCRHeader));
+		memset(&sourceTime, 0, sizeof(OCIDate));
+		oldColumns = 0;
+		newColumns = 0;
+		result = OCILCRHeaderGet(svc, errHandle, &header->sourceDatabase, &header->sourceDatabaseLength, &header->command, &header->commandLength,
+			&header->owner, &header->ownerLength, &header->object, &header->objectLength, &header->tag, &header->tagLength,
+			&header->transactionID, &header->transactionIDLength, &sourceTime, &oldColumns, &newColumns,
+			&header->position, &header->positionLength, &header->flags, lcrs[i], OCILCR_NEW_ONLY_MODE);
+		if (result != OCI_SUCCESS) {
+			break;
+		}
+		header->sourceYear = sourceTime.OCIDateYYYY;
+		header->sourceMonth = sourceTime.OCIDateMM;
+		header->sourceDay = sourceTime.OCIDateDD;
+		header->sourceHour = sourceTime.OCIDateTime.OCITimeHH;
+		header->sourceMinute = sourceTime.OCIDateTime.OCITimeMI;
+		header->sourceSecond = sourceTime.OCIDateTime.OCITimeSS;
+
+		if (types[i] == OCI_LCR_XROW) {
+			if (used + oldColumns + newColumns > scratchSize) {
+				*needed = oldColumns + newColumns;
+				break;
+			}
+			header->oldStart = used;
+			result = ociLCRColumnsRead(svc, errHandle, env, lcrs[i], OCI_LCR_ROW_COLVAL_OLD, &columns[used], oldColumns, &header->oldCount,
+				names, nameLengths, dataTypes, values, indicators, lengths, charsetForms, flags, charsetIDs);
+			if (result != OCI_SUCCESS) {
+				break;
+			}
+			used += header->oldCount;
+			header->newStart = used;
+			result = ociLCRColumnsRead(svc, errHandle, env, lcrs[i], OCI_LCR_ROW_COLVAL_NEW, &columns[used], newColumns, &header->newCount,
+				names, nameLengths, dataTypes, values, indicators, lengths, charsetForms, flags, charsetIDs);
+			if (result != OCI_SUCCESS) {
+				break;
+			}
+			used += header->newCount;
+		}
+		(*read)++;
+	}
+
+	free(names);
+	free(nameLengths);
+	free(dataTypes);
+	free(values);
+	free(indicators);
+	free(lengths);
+	free(charsetForms);
+	free(flags);
+	free(charsetIDs);
+	return result;
+}
+
+// ociLCRsFree frees the LCRs that are not NULL and sets them to NULL
+static void ociLCRsFree(OCISvcCtx *svc, OCIError *errHandle, ub4 count, void **lcrs) {
+	ub4 i;
+	for (i = 0; i < count; i++) {
+		if (lcrs[i] != NULL) {
+			OCILCRFree(svc, errHandle, lcrs[i], OCI_DEFAULT);
+			lcrs[i] = NULL;
+		}
+	}
+}
+
+// ociJsonText is the growing buffer the text of a JSON descriptor is written to by ociJsonToText, its data must be freed
+typedef struct {
+	ub1 *data;
+	size_t length;
+	size_t capacity;
+} ociJsonText;
+
+// ociJsonTextWrite is the write function of the stream used by ociJsonToText, the stream id is the ociJsonText
+static oraerr ociJsonTextWrite(void *streamContext, void *id, orastreamhdl *handle, const oratext *source, ubig_ora size, ubig_ora *written) {
+	ociJsonText *text = (ociJsonText *)id;
+	if (text->length + size > text->capacity) {
+		size_t capacity = text->capacity * 2;
+		ub1 *data;
+		if (capacity < text->length + size) {
+			capacity = text->length + size;
+		}
+		if (capacity < 4096) {
+			capacity = 4096;
+		}
+		data = realloc(text->data, capacity);
+		if (data == NULL) {
+			return 1;
+		}
+		text->data = data;
+		text->capacity = capacity;
+	}
+	memcpy(text->data + text->length, source, size);
+	text->length += size;
+	*written = size;
+	return 0;
+}
+
+// ociJsonToText converts a JSON descriptor to text in the client. The text is written through a stream
+// so it is converted in one call whatever its size, instead of guessing a buffer size and retrying.
+static sword ociJsonToText(OCISvcCtx *svc, OCIError *errHandle, OCIJson *json, ociJsonText *text) {
+	oraerr streamError = 0;
+	oraub8 length = 0;
+	sword result;
+	orastream *stream = OraStreamInit(NULL, text, &streamError, "write", ociJsonTextWrite, NULL);
+	if (stream == NULL) {
+		return OCI_INVALID_HANDLE;
+	}
+	result = OCIJsonToTextStream(svc, json, stream, &length, 0, errHandle, OCI_DEFAULT);
+	OraStreamTerm(stream);
+	return result;
+}
+
+// gobciJSONWrite is exported by json.go
+extern int gobciJSONWrite(uintptr_t id, void *source, size_t size);
+
+// ociJsonWriterWrite is the write function of the stream used by ociJsonToWriter, the stream id is the id of the Go writer
+static oraerr ociJsonWriterWrite(void *streamContext, void *id, orastreamhdl *handle, const oratext *source, ubig_ora size, ubig_ora *written) {
+	if (gobciJSONWrite((uintptr_t)id, (void *)source, size) != 0) {
+		return 1;
+	}
+	*written = size;
+	return 0;
+}
+
+// ociJsonToWriter converts a JSON descriptor to text in the client and writes it piece by piece to the Go writer with id
+static sword ociJsonToWriter(OCISvcCtx *svc, OCIError *errHandle, OCIJson *json, uintptr_t id) {
+	oraerr streamError = 0;
+	oraub8 length = 0;
+	sword result;
+	orastream *stream = OraStreamInit(NULL, (void *)id, &streamError, "write", ociJsonWriterWrite, NULL);
+	if (stream == NULL) {
+		return OCI_INVALID_HANDLE;
+	}
+	result = OCIJsonToTextStream(svc, json, stream, &length, 0, errHandle, OCI_DEFAULT);
+	OraStreamTerm(stream);
+	return result;
+}
+
+#endif
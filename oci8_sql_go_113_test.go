@@ -5,7 +5,12 @@ package gobci
 
 import (
 	"context"
+	"database/sql"
+	"database/sql/driver"
+	"fmt"
+	"strings"
 	"testing"
+	"time"
 )
 
 // TestStatementCaching tests to ensure statement caching is working
@@ -83,3 +88,456 @@ func TestStatementCaching(t *testing.T) {
 		t.Fatal("stmt close error:", err)
 	}
 }
+
+// TestDefineCache tests that cached statements keep described columns and define buffers between runs
+func TestDefineCache(t *testing.T) {
+	if TestDisableDatabase {
+		t.SkipNow()
+	}
+
+	t.Parallel()
+
+	db := testGetDB("?stmt_cache_size=10")
+	if db == nil {
+		t.Fatal("db is null")
+	}
+
+	defer func() {
+		err := db.Close()
+		if err != nil {
+			t.Fatal("db close error:", err)
+		}
+	}()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	conn, err := db.Conn(ctx)
+	cancel()
+	if err != nil {
+		t.Fatal("conn error:", err)
+	}
+	defer conn.Close()
+
+	query := "select 1 as A, 'abc' as B, systimestamp as C from dual"
+	for i := 0; i < 3; i++ {
+		ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+		var a int64
+		var b string
+		var c time.Time
+		err = conn.QueryRowContext(ctx, query).Scan(&a, &b, &c)
+		cancel()
+		if err != nil {
+			t.Fatal("scan error:", err)
+		}
+		if a != 1 || b != "abc" {
+			t.Fatalf("run %v: expected 1 abc, received %v %v", i, a, b)
+		}
+	}
+
+	err = conn.Raw(func(driverConn interface{}) error {
+		defineCache, ok := driverConn.(*Conn).defineCache[query]
+		if !ok {
+			return fmt.Errorf("no define cache for %v", query)
+		}
+		if len(defineCache.columns) != 3 || defineCache.columns[1].name != "B" {
+			return fmt.Errorf("unexpected columns %+v", defineCache.columns)
+		}
+		if len(defineCache.defines) != 3 || defineCache.defines[2].pbuf == nil {
+			return fmt.Errorf("define buffers not kept")
+		}
+		return nil
+	})
+	if err != nil {
+		t.Fatal(err)
+	}
+}
+
+// TestDefineCacheAlter tests that kept define buffers are not used after DDL widens a column
+func TestDefineCacheAlter(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "DEFINE_CACHE_" + TestTimeString
+	testExecQuery(t, "create table "+tableName+" ( A VARCHAR2(10) )", nil)
+	defer testDropTable(t, tableName)
+	testExecQuery(t, "insert into "+tableName+" ( A ) values ( 'abc' )", nil)
+
+	db := testGetDB("?stmt_cache_size=10")
+	if db == nil {
+		t.Fatal("db is null")
+	}
+	defer db.Close()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	conn, err := db.Conn(ctx)
+	cancel()
+	if err != nil {
+		t.Fatal("conn error:", err)
+	}
+	defer conn.Close()
+
+	query := "select A from " + tableName
+	for i, expected := range []string{"abc", strings.Repeat("x", 1000)} {
+		if i == 1 {
+			testExecQuery(t, "alter table "+tableName+" modify ( A VARCHAR2(1000) )", nil)
+			testExecQuery(t, "update "+tableName+" set A = :1", []interface{}{expected})
+		}
+
+		ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+		var a string
+		err = conn.QueryRowContext(ctx, query).Scan(&a)
+		cancel()
+		if err != nil {
+			t.Fatalf("run %v: scan error: %v", i, err)
+		}
+		if a != expected {
+			t.Fatalf("run %v: expected %v, received %v", i, expected, a)
+		}
+	}
+}
+
+// TestBindKept tests the bind buffers a statement keeps across executions
+func TestBindKept(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "BIND_KEPT_" + TestTimeString
+	testExecQuery(t, "create table "+tableName+" ( A INTEGER, B VARCHAR2(1000) )", nil)
+	defer testDropTable(t, tableName)
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	conn, err := TestDB.Conn(ctx)
+	cancel()
+	if err != nil {
+		t.Fatal("conn error:", err)
+	}
+	defer conn.Close()
+
+	// data types of the kept bind buffers
+	const sqltINT = 3  // C.SQLT_INT
+	const sqltAFC = 96 // C.SQLT_AFC
+
+	long := strings.Repeat("x", 500)
+	execs := []struct {
+		names      [2]string
+		values     [2]driver.Value
+		dataType   int
+		kept       bool // the buffer of the previous execution is reused
+		expected   interface{}
+		maxSizeMin int
+	}{
+		{[2]string{"a", "b"}, [2]driver.Value{int64(1), "abc"}, sqltAFC, false, "abc", 3},
+		{[2]string{"a", "b"}, [2]driver.Value{int64(2), "abd"}, sqltAFC, true, "abd", 3},     // same type and size, only copied
+		{[2]string{"a", "b"}, [2]driver.Value{int64(3), int64(42)}, sqltINT, false, "42", 8}, // type change
+		{[2]string{"a", "b"}, [2]driver.Value{int64(4), long}, sqltAFC, false, long, 500},    // grows past the kept capacity
+		{[2]string{"a", "b"}, [2]driver.Value{int64(5), "de"}, sqltAFC, true, "de", 500},     // shorter value
+		{[2]string{"a", "b"}, [2]driver.Value{int64(6), nil}, sqltAFC, true, nil, 500},       // NULL after a value
+		{[2]string{"", ""}, [2]driver.Value{int64(7), "fg"}, sqltAFC, false, "fg", 500},      // named to positional
+	}
+
+	ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+	err = conn.Raw(func(driverConn interface{}) error {
+		driverStmt, err := driverConn.(*Conn).PrepareContext(ctx, "insert into "+tableName+" ( A, B ) values ( :a, :b )")
+		if err != nil {
+			return err
+		}
+		stmt := driverStmt.(*Stmt)
+		defer stmt.Close()
+
+		for i, exec := range execs {
+			previous := bindStruct{}
+			if len(stmt.binds) > 1 {
+				previous = stmt.binds[1]
+			}
+
+			namedValues := []driver.NamedValue{
+				{Name: exec.names[0], Ordinal: 1, Value: exec.values[0]},
+				{Name: exec.names[1], Ordinal: 2, Value: exec.values[1]},
+			}
+			_, err = stmt.ExecContext(ctx, namedValues)
+			if err != nil {
+				return fmt.Errorf("exec %v error: %v", i, err)
+			}
+
+			bind := stmt.binds[1]
+			if int(bind.dataType) != exec.dataType {
+				return fmt.Errorf("exec %v - data type expected: %v - received: %v", i, exec.dataType, bind.dataType)
+			}
+			if int(bind.maxSize) < exec.maxSizeMin {
+				return fmt.Errorf("exec %v - buffer of %v bytes is smaller than %v", i, bind.maxSize, exec.maxSizeMin)
+			}
+			if bind.name != exec.names[1] {
+				return fmt.Errorf("exec %v - name expected: %v - received: %v", i, exec.names[1], bind.name)
+			}
+			// a new buffer may be allocated at the address of the freed one, so only a kept buffer is checked
+			if exec.kept && (bind.pbuf != previous.pbuf || bind.bindHandle != previous.bindHandle) {
+				return fmt.Errorf("exec %v - expected the buffer and bind handle to be kept", i)
+			}
+			if !exec.kept && i > 0 && bind.maxSize == previous.maxSize && bind.dataType == previous.dataType && bind.name == previous.name {
+				return fmt.Errorf("exec %v - expected the placeholder to be bound again", i)
+			}
+		}
+		return nil
+	})
+	cancel()
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	for _, exec := range execs {
+		ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+		var b sql.NullString
+		err = conn.QueryRowContext(ctx, "select B from "+tableName+" where A = :1", exec.values[0]).Scan(&b)
+		cancel()
+		if err != nil {
+			t.Fatal("scan error:", err)
+		}
+		if exec.expected == nil {
+			if b.Valid {
+				t.Fatalf("row %v - expected null - received: %v", exec.values[0], b.String)
+			}
+		} else if !b.Valid || b.String != exec.expected {
+			t.Fatalf("row %v - expected: %v - received: %v", exec.values[0], exec.expected, b)
+		}
+	}
+}
+
+// TestExecBatch tests array DML with ExecBatch
+func TestExecBatch(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "EXEC_BATCH_" + TestTimeString
+	testExecQuery(t, "create table "+tableName+" ( A INTEGER, B VARCHAR2(20), C BINARY_DOUBLE )", nil)
+	defer testDropTable(t, tableName)
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	conn, err := TestDB.Conn(ctx)
+	cancel()
+	if err != nil {
+		t.Fatal("conn error:", err)
+	}
+	defer conn.Close()
+
+	rows := [][]interface{}{
+		{1, "one", 1.5},
+		{2, nil, 2.5},
+		{3, "three", nil},
+	}
+
+	var result *BatchResult
+	ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+	err = conn.Raw(func(driverConn interface{}) error {
+		var err error
+		result, err = driverConn.(*Conn).ExecBatch(ctx, "insert into "+tableName+" ( A, B, C ) values (:1, :2, :3)", rows)
+		return err
+	})
+	cancel()
+	if err != nil {
+		t.Fatal("exec batch error:", err)
+	}
+
+	rowsAffected, _ := result.RowsAffected()
+	if rowsAffected != 3 {
+		t.Fatalf("rows affected - expected: %v - received: %v", 3, rowsAffected)
+	}
+
+	ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+	err = conn.Raw(func(driverConn interface{}) error {
+		var err error
+		result, err = driverConn.(*Conn).ExecBatch(ctx, "update "+tableName+" set B = 'x' where A >= :1", [][]interface{}{{1}, {3}, {4}})
+		return err
+	})
+	cancel()
+	if err != nil {
+		t.Fatal("exec batch error:", err)
+	}
+
+	rowCounts := result.RowCounts()
+	expected := []int64{3, 1, 0}
+	if len(rowCounts) != len(expected) {
+		t.Fatalf("row counts - expected: %v - received: %v", expected, rowCounts)
+	}
+	for i := range expected {
+		if rowCounts[i] != expected[i] {
+			t.Fatalf("row counts - expected: %v - received: %v", expected, rowCounts)
+		}
+	}
+}
+
+// TestSharedEnvironment tests that connections share the OCI environment
+func TestSharedEnvironment(t *testing.T) {
+	if TestDisableDatabase {
+		t.SkipNow()
+	}
+
+	var envs [2]*environmentStruct
+	for i := range envs {
+		ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+		conn, err := TestDB.Conn(ctx)
+		cancel()
+		if err != nil {
+			t.Fatal("conn error:", err)
+		}
+		defer conn.Close()
+
+		_ = conn.Raw(func(driverConn interface{}) error {
+			envs[i] = driverConn.(*Conn).environment
+			return nil
+		})
+	}
+
+	if envs[0] == nil || envs[0] != envs[1] {
+		t.Fatalf("environments not shared: %p %p", envs[0], envs[1])
+	}
+}
+
+// TestBulkLoader tests direct path loads with BulkLoader
+func TestBulkLoader(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "BULK_LOADER_" + TestTimeString
+	testExecQuery(t, "create table "+tableName+" ( A INTEGER, B VARCHAR2(20), C DATE, D TIMESTAMP(9), E RAW(4) )", nil)
+	defer testDropTable(t, tableName)
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	conn, err := TestDB.Conn(ctx)
+	cancel()
+	if err != nil {
+		t.Fatal("conn error:", err)
+	}
+	defer conn.Close()
+
+	aTime := time.Date(2006, 1, 2, 15, 4, 5, 0, time.UTC)
+	aTimestamp := time.Date(2006, 1, 2, 15, 4, 5, 123456789, time.UTC)
+	var stats BulkLoadStats
+	ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+	err = conn.Raw(func(driverConn interface{}) error {
+		loader, err := driverConn.(*Conn).NewBulkLoader(ctx, tableName, []string{"A", "B", "C", "D", "E"}, nil)
+		if err != nil {
+			return err
+		}
+		for i := 0; i < 1000; i++ {
+			err = loader.AppendRow(i, fmt.Sprint("row ", i), aTime, aTimestamp, []byte{1, 2, 0xab, 0xcd})
+			if err != nil {
+				loader.Abort()
+				return err
+			}
+		}
+		err = loader.AppendColumns([]interface{}{1000, "bad"}, []interface{}{nil, "x"}, []interface{}{nil, nil}, []interface{}{nil, nil}, []interface{}{nil, nil})
+		if err != nil {
+			loader.Abort()
+			return err
+		}
+		stats, err = loader.Finish()
+		return err
+	})
+	cancel()
+	if err != nil {
+		t.Fatal("bulk load error:", err)
+	}
+
+	if stats.Rows != 1001 || stats.Rejected != 1 {
+		t.Fatalf("rows, rejected - expected: %v, %v - received: %v, %v", 1001, 1, stats.Rows, stats.Rejected)
+	}
+	if stats.Bytes <= 0 {
+		t.Fatalf("bytes - expected more than 0 - received: %v", stats.Bytes)
+	}
+
+	queryResults := testQueryResults{
+		query: "select count(*), count(B), max(C), max(D), rawtohex(max(E)) from " + tableName,
+		queryResults: []testQueryResult{
+			{
+				results: [][]interface{}{{float64(1001), float64(1000), aTime, aTimestamp, "0102ABCD"}},
+			},
+		},
+	}
+	testRunQueryResults(t, queryResults)
+}
+
+// TestQueue tests array enqueue and dequeue with Queue
+func TestQueue(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	queueTable := "QUEUE_TABLE_" + TestTimeString
+	queueName := "QUEUE_" + TestTimeString
+	testExecQuery(t, "begin dbms_aqadm.create_queue_table(queue_table => '"+queueTable+"', queue_payload_type => 'RAW'); "+
+		"dbms_aqadm.create_queue(queue_name => '"+queueName+"', queue_table => '"+queueTable+"'); "+
+		"dbms_aqadm.start_queue(queue_name => '"+queueName+"'); end;", nil)
+	defer testExecQuery(t, "begin dbms_aqadm.drop_queue_table(queue_table => '"+queueTable+"', force => true); end;", nil)
+
+	db := testGetDB("?objects=true")
+	if db == nil {
+		t.Fatal("db is null")
+	}
+	defer db.Close()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	conn, err := db.Conn(ctx)
+	cancel()
+	if err != nil {
+		t.Fatal("conn error:", err)
+	}
+	defer conn.Close()
+
+	messages := make([]Message, 10)
+	for i := range messages {
+		messages[i], err = NewJSONMessage(map[string]int{"n": i})
+		if err != nil {
+			t.Fatal("json message error:", err)
+		}
+		messages[i].Correlation = "test"
+	}
+
+	var received []Message
+	ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+	err = conn.Raw(func(driverConn interface{}) error {
+		queue, err := driverConn.(*Conn).NewQueue(ctx, queueName, nil)
+		if err != nil {
+			return err
+		}
+		defer queue.Close()
+
+		err = queue.EnqueueBatch(ctx, messages)
+		if err != nil {
+			return err
+		}
+
+		for len(received) < len(messages) {
+			var batch []Message
+			batch, err = queue.DequeueBatch(ctx, 4)
+			if err != nil {
+				return err
+			}
+			if len(batch) == 0 {
+				return fmt.Errorf("dequeue timed out after %v messages", len(received))
+			}
+			received = append(received, batch...)
+		}
+		return nil
+	})
+	cancel()
+	if err != nil {
+		t.Fatal("queue error:", err)
+	}
+
+	for i := range messages {
+		if len(messages[i].ID) == 0 {
+			t.Fatalf("message %v has no id", i)
+		}
+		var value map[string]int
+		err = received[i].DecodeJSON(&value)
+		if err != nil {
+			t.Fatal("decode json error:", err)
+		}
+		if value["n"] != i || received[i].Correlation != "test" || string(received[i].ID) != string(messages[i].ID) {
+			t.Fatalf("message %v - expected: %v - received: %v %v", i, i, value["n"], received[i].Correlation)
+		}
+	}
+}
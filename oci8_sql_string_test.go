@@ -1,8 +1,10 @@
 package gobci
 
 import (
+	"bytes"
 	"context"
 	"database/sql"
+	"io/ioutil"
 	"strings"
 	"testing"
 )
@@ -3408,3 +3410,257 @@ func TestDestructiveStringColumnTypes(t *testing.T) {
 	}
 
 }
+
+// TestDestructiveLobStreaming checks reading CLOB and BLOB columns with Lob
+func TestDestructiveLobStreaming(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "LOB_STREAM_" + TestTimeString
+	err := testExec(t, "create table "+tableName+" ( A CLOB, B BLOB )", nil)
+	if err != nil {
+		t.Fatal("create table error:", err)
+	}
+	defer testDropTable(t, tableName)
+
+	clob := strings.Repeat("abcdefghij", 10000)
+	blob := bytes.Repeat([]byte{0, 1, 2, 3, 4, 5, 6, 7}, 20000)
+	err = testExec(t, "insert into "+tableName+" ( A, B ) values (:1, :2)", []interface{}{clob, blob})
+	if err != nil {
+		t.Fatal("insert error:", err)
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+	rows, err := TestDB.QueryContext(WithLobStreaming(ctx), "select A, B from "+tableName)
+	if err != nil {
+		t.Fatal("query error:", err)
+	}
+	defer rows.Close()
+
+	if !rows.Next() {
+		t.Fatal("no rows:", rows.Err())
+	}
+	var clobLob *Lob
+	var blobLob *Lob
+	err = rows.Scan(&clobLob, &blobLob)
+	if err != nil {
+		t.Fatal("scan error:", err)
+	}
+
+	var buffer bytes.Buffer
+	_, err = clobLob.WriteTo(&buffer)
+	if err != nil {
+		t.Fatal("clob WriteTo error:", err)
+	}
+	if buffer.String() != clob {
+		t.Fatalf("clob length %v does not match expected length %v", buffer.Len(), len(clob))
+	}
+
+	size, err := blobLob.Size()
+	if err != nil {
+		t.Fatal("blob Size error:", err)
+	}
+	if size != int64(len(blob)) {
+		t.Fatalf("blob size %v does not match expected size %v", size, len(blob))
+	}
+
+	part := make([]byte, 100)
+	_, err = blobLob.ReadAt(part, 1003)
+	if err != nil {
+		t.Fatal("blob ReadAt error:", err)
+	}
+	if !bytes.Equal(part, blob[1003:1103]) {
+		t.Fatal("blob ReadAt does not match")
+	}
+
+	data, err := ioutil.ReadAll(blobLob)
+	if err != nil {
+		t.Fatal("blob read error:", err)
+	}
+	if !bytes.Equal(data, blob) {
+		t.Fatalf("blob length %v does not match expected length %v", len(data), len(blob))
+	}
+
+	err = blobLob.Close()
+	if err != nil {
+		t.Fatal("blob close error:", err)
+	}
+}
+
+// TestDestructiveLobInline checks reading CLOB and BLOB columns inline and with LOB prefetch
+func TestDestructiveLobInline(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "LOB_INLINE_" + TestTimeString
+	err := testExec(t, "create table "+tableName+" ( A CLOB, B BLOB )", nil)
+	if err != nil {
+		t.Fatal("create table error:", err)
+	}
+	defer testDropTable(t, tableName)
+
+	clob := strings.Repeat("abc", 100)
+	blob := bytes.Repeat([]byte{1, 2, 3}, 100)
+	err = testExec(t, "insert into "+tableName+" ( A, B ) values (:1, :2)", []interface{}{clob, blob})
+	if err != nil {
+		t.Fatal("insert error:", err)
+	}
+
+	contexts := []func(context.Context) context.Context{
+		func(ctx context.Context) context.Context { return WithLobInlineSize(ctx, 1000) },
+		func(ctx context.Context) context.Context { return WithLobPrefetchSize(ctx, 1000) },
+	}
+	for _, withOption := range contexts {
+		ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+		var a string
+		var b []byte
+		err = TestDB.QueryRowContext(withOption(ctx), "select A, B from "+tableName).Scan(&a, &b)
+		cancel()
+		if err != nil {
+			t.Fatal("scan error:", err)
+		}
+		if a != clob || !bytes.Equal(b, blob) {
+			t.Fatalf("received %v %v", a, b)
+		}
+	}
+
+	// a LOB larger than the inline size is an error
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	var a string
+	var b []byte
+	err = TestDB.QueryRowContext(WithLobInlineSize(ctx, 100), "select A, B from "+tableName).Scan(&a, &b)
+	cancel()
+	if err == nil {
+		t.Fatal("expected truncation error")
+	}
+}
+
+// TestDestructiveLobArrayRead checks reading CLOB and BLOB columns of a fetched batch with one array read
+func TestDestructiveLobArrayRead(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "LOB_ARRAY_" + TestTimeString
+	err := testExec(t, "create table "+tableName+" ( A INTEGER, B CLOB, C BLOB )", nil)
+	if err != nil {
+		t.Fatal("create table error:", err)
+	}
+	defer testDropTable(t, tableName)
+
+	clobs := []interface{}{"a", nil, strings.Repeat("0123456789", 5000), "", strings.Repeat("x", 16383)}
+	blobs := []interface{}{[]byte{1}, []byte{2, 3}, nil, bytes.Repeat([]byte{4, 5}, 20000), bytes.Repeat([]byte{6}, 16384)}
+	for i := range clobs {
+		err = testExec(t, "insert into "+tableName+" ( A, B, C ) values (:1, :2, :3)", []interface{}{i, clobs[i], blobs[i]})
+		if err != nil {
+			t.Fatal("insert error:", err)
+		}
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+	rows, err := TestDB.QueryContext(WithFetchArraySize(ctx, 10), "select A, B, C from "+tableName+" order by A")
+	if err != nil {
+		t.Fatal("query error:", err)
+	}
+	defer rows.Close()
+
+	var i int
+	for rows.Next() {
+		var a int
+		var b sql.NullString
+		var c []byte
+		err = rows.Scan(&a, &b, &c)
+		if err != nil {
+			t.Fatal("scan error:", err)
+		}
+
+		// Oracle stores an empty CLOB as null
+		if clobs[i] == nil || clobs[i] == "" {
+			if b.Valid && b.String != "" {
+				t.Errorf("row %v: expected null clob, received %q", i, b.String)
+			}
+		} else if b.String != clobs[i].(string) {
+			t.Errorf("row %v: clob length %v does not match expected length %v", i, len(b.String), len(clobs[i].(string)))
+		}
+		if blobs[i] == nil {
+			if c != nil {
+				t.Errorf("row %v: expected null blob, received %v bytes", i, len(c))
+			}
+		} else if !bytes.Equal(c, blobs[i].([]byte)) {
+			t.Errorf("row %v: blob length %v does not match expected length %v", i, len(c), len(blobs[i].([]byte)))
+		}
+		i++
+	}
+	err = rows.Err()
+	if err != nil {
+		t.Fatal("rows error:", err)
+	}
+	if i != len(clobs) {
+		t.Fatalf("expected %v rows, received %v", len(clobs), i)
+	}
+}
+
+// TestDestructiveStreamValue checks inserting CLOB and BLOB values from an io.Reader piece by piece
+func TestDestructiveStreamValue(t *testing.T) {
+	if TestDisableDatabase || TestDisableDestructive {
+		t.SkipNow()
+	}
+
+	tableName := "STREAM_VALUE_" + TestTimeString
+	err := testExec(t, "create table "+tableName+" ( A INTEGER, B CLOB, C BLOB )", nil)
+	if err != nil {
+		t.Fatal("create table error:", err)
+	}
+	defer testDropTable(t, tableName)
+
+	clob := strings.Repeat("0123456789", 25000)
+	blob := bytes.Repeat([]byte{0, 1, 2, 3, 4, 5, 6, 7, 8}, 30000)
+	err = testExec(t, "insert into "+tableName+" ( A, B, C ) values (:1, :2, :3)", []interface{}{
+		1,
+		StreamValue{Reader: strings.NewReader(clob), Text: true, PieceSize: 10000},
+		&StreamValue{Reader: bytes.NewReader(blob), Size: int64(len(blob))},
+	})
+	if err != nil {
+		t.Fatal("insert error:", err)
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	var b string
+	var c []byte
+	err = TestDB.QueryRowContext(ctx, "select B, C from "+tableName+" where A = 1").Scan(&b, &c)
+	cancel()
+	if err != nil {
+		t.Fatal("scan error:", err)
+	}
+	if b != clob {
+		t.Fatalf("clob length %v does not match expected length %v", len(b), len(clob))
+	}
+	if !bytes.Equal(c, blob) {
+		t.Fatalf("blob length %v does not match expected length %v", len(c), len(blob))
+	}
+
+	// a reader that ends before Size is an error and nothing is inserted
+	err = testExec(t, "insert into "+tableName+" ( A, B, C ) values (:1, :2, :3)", []interface{}{
+		2,
+		nil,
+		&StreamValue{Reader: bytes.NewReader(blob[:1000]), Size: int64(len(blob))},
+	})
+	if err == nil {
+		t.Fatal("insert of a short stream value - expected an error")
+	}
+
+	ctx, cancel = context.WithTimeout(context.Background(), TestContextTimeout)
+	var count int64
+	err = TestDB.QueryRowContext(ctx, "select count(*) from "+tableName+" where A = 2").Scan(&count)
+	cancel()
+	if err != nil {
+		t.Fatal("scan error:", err)
+	}
+	if count != 0 {
+		t.Fatalf("expected no row for the short stream value, received %v", count)
+	}
+}
@@ -3,7 +3,11 @@ package gobci
 import (
 	"context"
 	"database/sql"
+	"database/sql/driver"
+	"encoding/json"
 	"fmt"
+	"io"
+	"io/ioutil"
 	"log"
 	"os"
 	"reflect"
@@ -1259,6 +1263,243 @@ func TestQuestionMark(t *testing.T) {
 	}
 }
 
+// TestArrayFetch tests fetching rows in batches with fetch_array_size and WithFetchArraySize
+func TestArrayFetch(t *testing.T) {
+	if TestDisableDatabase {
+		t.SkipNow()
+	}
+
+	t.Parallel()
+
+	var err error
+
+	db := testGetDB("?fetch_array_size=7")
+	if db == nil {
+		t.Fatal("db is null")
+	}
+
+	defer func() {
+		err = db.Close()
+		if err != nil {
+			t.Fatal("db close error:", err)
+		}
+	}()
+
+	for _, fetchArraySize := range []int{0, 1, 10, 25, 100} {
+		ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+		if fetchArraySize > 0 {
+			ctx = WithFetchArraySize(ctx, fetchArraySize)
+		}
+		rows, err := db.QueryContext(ctx, "select level, to_char(level), sysdate from dual connect by level <= 25")
+		if err != nil {
+			cancel()
+			t.Fatal("query error:", err)
+		}
+
+		count := 0
+		for rows.Next() {
+			var number int64
+			var aString string
+			var aTime time.Time
+			err = rows.Scan(&number, &aString, &aTime)
+			if err != nil {
+				rows.Close()
+				cancel()
+				t.Fatal("scan error:", err)
+			}
+			count++
+			if number != int64(count) || aString != strconv.Itoa(count) {
+				rows.Close()
+				cancel()
+				t.Fatalf("fetch array size %v - row %v - received: %v, %v", fetchArraySize, count, number, aString)
+			}
+		}
+		err = rows.Err()
+		rows.Close()
+		cancel()
+		if err != nil {
+			t.Fatal("rows error:", err)
+		}
+		if count != 25 {
+			t.Fatalf("fetch array size %v - expected 25 rows - received: %v", fetchArraySize, count)
+		}
+	}
+}
+
+// TestImplicitResults tests reading the result sets returned by DBMS_SQL.RETURN_RESULT
+func TestImplicitResults(t *testing.T) {
+	if TestDisableDatabase {
+		t.SkipNow()
+	}
+
+	t.Parallel()
+
+	query := `declare
+	l_cursor1 SYS_REFCURSOR;
+	l_cursor2 SYS_REFCURSOR;
+begin
+	open l_cursor1 for select level from dual connect by level <= 3;
+	DBMS_SQL.RETURN_RESULT(l_cursor1);
+	open l_cursor2 for select 'a', 'b' from dual;
+	DBMS_SQL.RETURN_RESULT(l_cursor2);
+end;`
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+	rows, err := TestDB.QueryContext(ctx, query)
+	if err != nil {
+		t.Fatal("query error:", err)
+	}
+	defer rows.Close()
+
+	var numbers []int64
+	for rows.Next() {
+		var number int64
+		err = rows.Scan(&number)
+		if err != nil {
+			t.Fatal("scan error:", err)
+		}
+		numbers = append(numbers, number)
+	}
+	if !reflect.DeepEqual(numbers, []int64{1, 2, 3}) {
+		t.Fatalf("first result set - received: %v", numbers)
+	}
+
+	if !rows.NextResultSet() {
+		t.Fatal("no second result set:", rows.Err())
+	}
+	if !rows.Next() {
+		t.Fatal("no row in second result set:", rows.Err())
+	}
+	var a, b string
+	err = rows.Scan(&a, &b)
+	if err != nil {
+		t.Fatal("scan error:", err)
+	}
+	if a != "a" || b != "b" {
+		t.Fatalf("second result set - received: %v, %v", a, b)
+	}
+	if rows.Next() {
+		t.Fatal("more than one row in second result set")
+	}
+
+	if rows.NextResultSet() {
+		t.Fatal("third result set")
+	}
+	err = rows.Err()
+	if err != nil {
+		t.Fatal("rows error:", err)
+	}
+}
+
+// TestRefCursorOut tests a REF CURSOR out bind
+func TestRefCursorOut(t *testing.T) {
+	if TestDisableDatabase {
+		t.SkipNow()
+	}
+
+	t.Parallel()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+
+	var cursor driver.Rows
+	_, err := TestDB.ExecContext(ctx, "begin open :1 for select level from dual connect by level <= 5; end;", sql.Out{Dest: &cursor})
+	if err != nil {
+		t.Fatal("exec error:", err)
+	}
+	if cursor == nil {
+		t.Fatal("cursor is nil")
+	}
+	defer cursor.Close()
+
+	dest := make([]driver.Value, 1)
+	var numbers []float64
+	for {
+		err = cursor.Next(dest)
+		if err == io.EOF {
+			break
+		}
+		if err != nil {
+			t.Fatal("next error:", err)
+		}
+		numbers = append(numbers, dest[0].(float64))
+	}
+	if !reflect.DeepEqual(numbers, []float64{1, 2, 3, 4, 5}) {
+		t.Fatalf("cursor rows - received: %v", numbers)
+	}
+}
+
+// TestJSON tests fetching and binding native JSON values, Oracle 21c and later
+func TestJSON(t *testing.T) {
+	if TestDisableDatabase {
+		t.SkipNow()
+	}
+
+	t.Parallel()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+
+	query := `select json('{"name":"a","values":[1,2]}') from dual`
+	expected := map[string]interface{}{"name": "a", "values": []interface{}{float64(1), float64(2)}}
+
+	var document map[string]interface{}
+	err := TestDB.QueryRowContext(ctx, query).Scan(JSON{Value: &document})
+	if err != nil {
+		t.Fatal("scan error:", err)
+	}
+	if !reflect.DeepEqual(document, expected) {
+		t.Fatalf("JSON - expected: %v - received: %v", expected, document)
+	}
+
+	var raw json.RawMessage
+	err = TestDB.QueryRowContext(ctx, query).Scan(&raw)
+	if err != nil {
+		t.Fatal("scan error:", err)
+	}
+	document = nil
+	err = json.Unmarshal(raw, &document)
+	if err != nil {
+		t.Fatal("unmarshal error:", err)
+	}
+	if !reflect.DeepEqual(document, expected) {
+		t.Fatalf("json.RawMessage - expected: %v - received: %v", expected, document)
+	}
+
+	var streamed struct {
+		Name   string
+		Values []int
+	}
+	err = TestDB.QueryRowContext(WithJSONStreaming(ctx), query).Scan(JSON{Value: &streamed})
+	if err != nil {
+		t.Fatal("streaming scan error:", err)
+	}
+	if streamed.Name != "a" || !reflect.DeepEqual(streamed.Values, []int{1, 2}) {
+		t.Fatalf("streaming JSON - received: %+v", streamed)
+	}
+
+	// a document not closed is closed with its rows
+	var jsonDocument *JSONDocument
+	err = TestDB.QueryRowContext(WithJSONStreaming(ctx), query).Scan(&jsonDocument)
+	if err != nil {
+		t.Fatal("document scan error:", err)
+	}
+	_, err = jsonDocument.WriteTo(ioutil.Discard)
+	if err == nil {
+		t.Fatal("document WriteTo after rows close - expected an error")
+	}
+
+	var name string
+	err = TestDB.QueryRowContext(ctx, "select json_value(:1, '$.name') from dual", JSON{Value: map[string]string{"name": "b"}}).Scan(&name)
+	if err != nil {
+		t.Fatal("bind scan error:", err)
+	}
+	if name != "b" {
+		t.Fatalf("bind JSON - expected: b - received: %v", name)
+	}
+}
+
 func BenchmarkSimpleInsert(b *testing.B) {
 	if TestDisableDatabase || TestDisableDestructive {
 		b.SkipNow()
@@ -1651,6 +1892,87 @@ func BenchmarkSelectWithCaching(b *testing.B) {
 	}
 }
 
+// BenchmarkSelectWideNumeric reports allocations per row when scanning many numeric columns
+func BenchmarkSelectWideNumeric(b *testing.B) {
+	b.StopTimer()
+
+	if TestDisableDatabase {
+		b.SkipNow()
+	}
+
+	const columnCount = 40
+	columns := make([]string, columnCount)
+	dest := make([]interface{}, columnCount)
+	values := make([]float64, columnCount)
+	for i := 0; i < columnCount; i++ {
+		columns[i] = fmt.Sprintf("level * %v + 0.5", i)
+		dest[i] = &values[i]
+	}
+	query := "select " + strings.Join(columns, ", ") + " from dual connect by level <= :1"
+
+	b.ReportAllocs()
+	b.StartTimer()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+	rows, err := TestDB.QueryContext(ctx, query, b.N)
+	if err != nil {
+		b.Fatal("query error:", err)
+	}
+	defer rows.Close()
+
+	for rows.Next() {
+		err = rows.Scan(dest...)
+		if err != nil {
+			b.Fatal("scan error:", err)
+		}
+	}
+	err = rows.Err()
+	if err != nil {
+		b.Fatal("rows error:", err)
+	}
+}
+
+func BenchmarkSelectDates(b *testing.B) {
+	b.StopTimer()
+
+	if TestDisableDatabase {
+		b.SkipNow()
+	}
+
+	const columnCount = 6
+	columns := make([]string, columnCount)
+	dest := make([]interface{}, columnCount)
+	values := make([]time.Time, columnCount)
+	for i := 0; i < columnCount; i++ {
+		columns[i] = fmt.Sprintf("sysdate + level / %v", i+1)
+		dest[i] = &values[i]
+	}
+	query := "select " + strings.Join(columns, ", ") + " from dual connect by level <= :1"
+
+	b.ReportAllocs()
+	b.StartTimer()
+
+	ctx, cancel := context.WithTimeout(context.Background(), TestContextTimeout)
+	defer cancel()
+	rows, err := TestDB.QueryContext(ctx, query, b.N)
+	if err != nil {
+		b.Fatal("query error:", err)
+	}
+	defer rows.Close()
+
+	for rows.Next() {
+		err = rows.Scan(dest...)
+		if err != nil {
+			b.Fatal("scan error:", err)
+		}
+	}
+	err = rows.Err()
+	if err != nil {
+		b.Fatal("rows error:", err)
+	}
+}
+
 func BenchmarkPrefetchR0M32768(b *testing.B) {
 	b.StopTimer()
 
@@ -0,0 +1,120 @@
+package gobci
+
+import (
+	"context"
+)
+
+type contextKey int
+
+const (
+	fetchArraySizeKey contextKey = iota
+	lobStreamingKey
+	lobPrefetchSizeKey
+	lobInlineSizeKey
+	prefetchKey
+	prefetchBudgetKey
+	jsonStreamingKey
+)
+
+// WithFetchArraySize returns a context that overrides the fetch_array_size DSN parameter
+// for queries run with it. Size is the number of rows fetched by each fetch call and must be at least 1.
+// Sizes larger than 16777216 are reduced to it.
+func WithFetchArraySize(ctx context.Context, size int) context.Context {
+	return context.WithValue(ctx, fetchArraySizeKey, size)
+}
+
+// fetchArraySizeFor returns the fetch array size from ctx or the connection default
+func (conn *Conn) fetchArraySizeFor(ctx context.Context) int {
+	if size, ok := ctx.Value(fetchArraySizeKey).(int); ok && size > 0 {
+		if size > maxArraySize {
+			return maxArraySize
+		}
+		return size
+	}
+	if conn.fetchArraySize > 0 {
+		return conn.fetchArraySize
+	}
+	return 1
+}
+
+// WithLobStreaming returns a context so queries run with it return CLOB and BLOB columns as *Lob
+// that read the value on demand, instead of reading each whole value into a string or []byte.
+// Scan the column into a **Lob, for example: var lob *gobci.Lob; rows.Scan(&lob)
+func WithLobStreaming(ctx context.Context) context.Context {
+	return context.WithValue(ctx, lobStreamingKey, true)
+}
+
+// lobStreaming returns true if LOB columns are returned as *Lob for ctx
+func lobStreaming(ctx context.Context) bool {
+	streaming, _ := ctx.Value(lobStreamingKey).(bool)
+	return streaming
+}
+
+// WithLobPrefetchSize returns a context that overrides the lob_prefetch_size DSN parameter for queries run with it.
+// Size is the number of bytes of CLOB and BLOB data prefetched with each locator, 0 disables LOB prefetch.
+func WithLobPrefetchSize(ctx context.Context, size int) context.Context {
+	return context.WithValue(ctx, lobPrefetchSizeKey, size)
+}
+
+// lobPrefetchSizeFor returns the LOB prefetch size from ctx or the connection default
+func (conn *Conn) lobPrefetchSizeFor(ctx context.Context) int {
+	if size, ok := ctx.Value(lobPrefetchSizeKey).(int); ok && size >= 0 {
+		return size
+	}
+	return conn.lobPrefetchSize
+}
+
+// WithLobInlineSize returns a context that overrides the lob_inline_size DSN parameter for queries run with it.
+// Size is the number of bytes of the long string and raw buffers CLOB and BLOB columns are defined as,
+// 0 fetches locators. Max 32767.
+func WithLobInlineSize(ctx context.Context, size int) context.Context {
+	return context.WithValue(ctx, lobInlineSizeKey, size)
+}
+
+// lobInlineSizeFor returns the LOB inline size from ctx or the connection default
+func (conn *Conn) lobInlineSizeFor(ctx context.Context) int {
+	if size, ok := ctx.Value(lobInlineSizeKey).(int); ok && size >= 0 && size <= 32767 {
+		return size
+	}
+	return conn.lobInlineSize
+}
+
+// WithPrefetch returns a context that overrides the prefetch_rows and prefetch_memory DSN parameters
+// for queries run with it. A 0 rows means only memory limits the rows, a 0 memory means unlimited memory.
+func WithPrefetch(ctx context.Context, rows int, memory int) context.Context {
+	return context.WithValue(ctx, prefetchKey, prefetchStruct{rows: rows, memory: memory})
+}
+
+// WithAdaptivePrefetch returns a context that overrides the prefetch_budget DSN parameter for queries run with it.
+// Budget is the max bytes of rows prefetched by each round trip, 0 disables adaptive prefetch.
+func WithAdaptivePrefetch(ctx context.Context, budget int) context.Context {
+	return context.WithValue(ctx, prefetchBudgetKey, budget)
+}
+
+// prefetchFor returns the prefetch from ctx or the connection default
+func (conn *Conn) prefetchFor(ctx context.Context) prefetchStruct {
+	if prefetch, ok := ctx.Value(prefetchKey).(prefetchStruct); ok && prefetch.rows >= 0 && prefetch.memory >= 0 {
+		return prefetch
+	}
+	budget, ok := ctx.Value(prefetchBudgetKey).(int)
+	if !ok || budget < 0 {
+		budget = conn.prefetchBudget
+	}
+	if budget > 0 {
+		return prefetchStruct{rows: prefetchStartRows, budget: budget}
+	}
+	return prefetchStruct{rows: int(conn.prefetchRows), memory: int(conn.prefetchMemory)}
+}
+
+// WithJSONStreaming returns a context so queries run with it return native JSON columns as *JSONDocument
+// that convert the value to text piece by piece when read, instead of converting each whole value into []byte.
+// Scan the column into a **JSONDocument, or into a JSON to decode it without holding its text.
+func WithJSONStreaming(ctx context.Context) context.Context {
+	return context.WithValue(ctx, jsonStreamingKey, true)
+}
+
+// jsonStreaming returns true if JSON columns are returned as *JSONDocument for ctx
+func jsonStreaming(ctx context.Context) bool {
+	streaming, _ := ctx.Value(jsonStreamingKey).(bool)
+	return streaming
+}
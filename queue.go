@@ -0,0 +1,518 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"context"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"time"
+	"unsafe"
+)
+
+// NewQueue opens the Advanced Queuing queue name, which must have RAW payloads.
+// The connection must be opened with the objects DSN parameter.
+// Messages are enqueued and dequeued as part of the transaction when the connection is in one, else immediately.
+// To get the driver Conn from a sql.Conn use sql.Conn.Raw
+func (conn *Conn) NewQueue(ctx context.Context, name string, options *QueueOptions) (*Queue, error) {
+	if conn.environment.mode&C.OCI_OBJECT == 0 {
+		return nil, errors.New("queue needs a connection opened with objects=true")
+	}
+	if options == nil {
+		options = &QueueOptions{}
+	}
+
+	queue := &Queue{
+		conn: conn,
+		name: cString(name),
+	}
+
+	armed := conn.watchCancel(ctx)
+	result := C.ociAQRawType(
+		conn.env,           // environment handle
+		conn.errHandle,     // error handle
+		conn.svc,           // service context
+		&queue.payloadType, // returns the type descriptor of RAW payloads
+	)
+	conn.unwatchCancel(armed)
+	err := conn.getError(result)
+	if err != nil {
+		queue.free()
+		return nil, fmt.Errorf("queue payload type error: %v", err)
+	}
+
+	descriptor, _, err := conn.ociDescriptorAlloc(C.OCI_DTYPE_AQENQ_OPTIONS, 0)
+	if err != nil {
+		queue.free()
+		return nil, fmt.Errorf("allocate enqueue options error: %v", err)
+	}
+	queue.enqueueOptions = *descriptor
+
+	descriptor, _, err = conn.ociDescriptorAlloc(C.OCI_DTYPE_AQDEQ_OPTIONS, 0)
+	if err != nil {
+		queue.free()
+		return nil, fmt.Errorf("allocate dequeue options error: %v", err)
+	}
+	queue.dequeueOptions = *descriptor
+
+	if options.Consumer != "" {
+		err = queue.setStringOption(options.Consumer, C.OCI_ATTR_CONSUMER_NAME)
+		if err != nil {
+			queue.free()
+			return nil, fmt.Errorf("queue consumer error: %v", err)
+		}
+	}
+	if options.Correlation != "" {
+		err = queue.setStringOption(options.Correlation, C.OCI_ATTR_CORRELATION)
+		if err != nil {
+			queue.free()
+			return nil, fmt.Errorf("queue correlation error: %v", err)
+		}
+	}
+
+	return queue, nil
+}
+
+// setStringOption sets a text attribute of the dequeue options
+func (queue *Queue) setStringOption(value string, attributeType C.ub4) error {
+	cValue := cString(value)
+	defer C.free(unsafe.Pointer(cValue))
+	return queue.conn.ociAttrSet(queue.dequeueOptions, C.OCI_DTYPE_AQDEQ_OPTIONS, unsafe.Pointer(cValue), C.ub4(len(value)), attributeType)
+}
+
+// setVisibility sets the visibility of enqueue or dequeue options from the transaction state of the connection.
+// The enqueue and dequeue visibility constants have the same values.
+func (queue *Queue) setVisibility(options unsafe.Pointer, optionsType C.ub4) error {
+	visibility := C.ub4(C.OCI_ENQ_IMMEDIATE)
+	if queue.conn.inTransaction {
+		visibility = C.OCI_ENQ_ON_COMMIT
+	}
+	return queue.conn.ociAttrSet(options, optionsType, unsafe.Pointer(&visibility), 0, C.OCI_ATTR_VISIBILITY)
+}
+
+// ensureCapacity grows the message arrays to hold at least count messages
+func (queue *Queue) ensureCapacity(count int) error {
+	if count <= queue.capacity {
+		return nil
+	}
+	queue.freeArrays()
+
+	properties, err := queue.conn.ociDescriptorAllocArray(C.OCI_DTYPE_AQMSG_PROPERTIES, count)
+	if err != nil {
+		return fmt.Errorf("allocate message properties error: %v", err)
+	}
+	queue.properties = properties
+	queue.payloads = C.calloc(C.size_t(count), C.size_t(sizeOfNilPointer))
+	queue.ids = C.calloc(C.size_t(count), C.size_t(sizeOfNilPointer))
+	queue.indicators = C.calloc(C.size_t(count), C.sizeof_sb2)
+	queue.indicatorPointers = C.malloc(C.size_t(count) * C.size_t(sizeOfNilPointer))
+	queue.fields = C.calloc(C.size_t(count), C.sizeof_ociAQMessageFields)
+	queue.capacity = count
+
+	indicatorPointers := (*[1 << 28]unsafe.Pointer)(queue.indicatorPointers)[:count:count]
+	for i := range indicatorPointers {
+		indicatorPointers[i] = unsafe.Pointer(uintptr(queue.indicators) + uintptr(i)*C.sizeof_sb2)
+	}
+
+	return nil
+}
+
+// messageFields returns the first count message fields
+func (queue *Queue) messageFields(count int) []C.ociAQMessageFields {
+	return (*[1 << 20]C.ociAQMessageFields)(queue.fields)[:count:count]
+}
+
+// EnqueueBatch enqueues messages in one round trip and sets their ID.
+// If an error is returned, the messages before the one in error were enqueued and have their ID set.
+func (queue *Queue) EnqueueBatch(ctx context.Context, messages []Message) error {
+	if queue.closed {
+		return errors.New("queue is closed")
+	}
+	if len(messages) == 0 {
+		return nil
+	}
+	if ctx.Err() != nil {
+		return ctx.Err()
+	}
+
+	conn := queue.conn
+	err := queue.ensureCapacity(len(messages))
+	if err != nil {
+		return err
+	}
+
+	// payloads and correlations are copied to C memory for OCIRawAssignBytes and OCIAttrSet
+	size := 1
+	for i := range messages {
+		size += len(messages[i].Payload) + len(messages[i].Correlation)
+	}
+	arena := C.malloc(C.size_t(size))
+	defer C.free(arena)
+	buffer := (*[1 << 30]byte)(arena)[:size:size]
+
+	offset := 0
+	fields := queue.messageFields(len(messages))
+	for i := range messages {
+		message := &messages[i]
+		fields[i].payload = (*C.ub1)(unsafe.Pointer(&buffer[offset]))
+		fields[i].payloadLength = C.ub4(copy(buffer[offset:], message.Payload))
+		offset += len(message.Payload)
+		fields[i].correlation = (*C.OraText)(unsafe.Pointer(&buffer[offset]))
+		fields[i].correlationLength = C.ub4(copy(buffer[offset:], message.Correlation))
+		offset += len(message.Correlation)
+		fields[i].priority = C.sb4(message.Priority)
+		fields[i].delay = C.sb4(message.Delay / time.Second)
+		fields[i].expiration = C.OCI_MSG_NO_EXPIRATION
+		if message.Expiration > 0 {
+			fields[i].expiration = C.sb4(message.Expiration / time.Second)
+		}
+	}
+
+	result := C.ociAQMessagesSet(
+		conn.env,                            // environment handle
+		conn.errHandle,                      // error handle
+		C.ub4(len(messages)),                // number of messages
+		(*unsafe.Pointer)(queue.properties), // message properties descriptors
+		(*unsafe.Pointer)(queue.payloads),   // RAW payloads, allocated if NULL
+		&fields[0],                          // payloads and properties to set
+	)
+	err = conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("set messages error: %v", err)
+	}
+
+	err = queue.setVisibility(queue.enqueueOptions, C.OCI_DTYPE_AQENQ_OPTIONS)
+	if err != nil {
+		return fmt.Errorf("enqueue visibility error: %v", err)
+	}
+
+	iters := C.ub4(len(messages))
+	armed := conn.watchCancel(ctx)
+	result = C.ociAQEnqArray(
+		conn.svc,                            // service context
+		conn.errHandle,                      // error handle
+		queue.name,                          // name of the queue
+		queue.enqueueOptions,                // enqueue options
+		&iters,                              // number of messages, returns the number enqueued
+		(*unsafe.Pointer)(queue.properties), // message properties descriptors
+		queue.payloadType,                   // type descriptor of the payloads
+		(*unsafe.Pointer)(queue.payloads),   // payloads
+		(*unsafe.Pointer)(queue.indicatorPointers), // payload null indicators
+		(*unsafe.Pointer)(queue.ids),               // returns the message ids
+	)
+	conn.unwatchCancel(armed)
+	enqueueErr := conn.getError(result)
+	if enqueueErr == ErrOCISuccessWithInfo {
+		enqueueErr = nil
+	}
+	if iters > C.ub4(len(messages)) || (enqueueErr == nil && iters == 0) {
+		iters = C.ub4(len(messages))
+	}
+
+	err = queue.readMessages(messages[:iters], false)
+	if enqueueErr != nil {
+		return fmt.Errorf("enqueue message %v - error: %v", int(iters), enqueueErr)
+	}
+	return err
+}
+
+// DequeueBatch dequeues up to max messages in one round trip.
+// It waits for messages until the ctx deadline, or until ctx is done when ctx has no deadline.
+// If no message arrives before the deadline, it returns no messages and a nil error.
+func (queue *Queue) DequeueBatch(ctx context.Context, max int) ([]Message, error) {
+	if queue.closed {
+		return nil, errors.New("queue is closed")
+	}
+	if max < 1 {
+		return nil, fmt.Errorf("dequeue max %v is less than 1", max)
+	}
+	if ctx.Err() != nil {
+		return nil, ctx.Err()
+	}
+
+	conn := queue.conn
+	err := queue.ensureCapacity(max)
+	if err != nil {
+		return nil, err
+	}
+
+	// the wait is rounded down to seconds so the dequeue returns before the call timeout set from the deadline
+	var wait C.sb4 = C.OCI_DEQ_WAIT_FOREVER
+	if deadline, ok := ctx.Deadline(); ok {
+		wait = C.sb4(time.Until(deadline) / time.Second)
+		if wait < 0 {
+			wait = 0
+		}
+	}
+	err = conn.ociAttrSet(queue.dequeueOptions, C.OCI_DTYPE_AQDEQ_OPTIONS, unsafe.Pointer(&wait), 0, C.OCI_ATTR_WAIT)
+	if err != nil {
+		return nil, fmt.Errorf("dequeue wait error: %v", err)
+	}
+	err = queue.setVisibility(queue.dequeueOptions, C.OCI_DTYPE_AQDEQ_OPTIONS)
+	if err != nil {
+		return nil, fmt.Errorf("dequeue visibility error: %v", err)
+	}
+
+	iters := C.ub4(max)
+	armed := conn.watchCancel(ctx)
+	result := C.ociAQDeqArray(
+		conn.svc,                            // service context
+		conn.errHandle,                      // error handle
+		queue.name,                          // name of the queue
+		queue.dequeueOptions,                // dequeue options
+		&iters,                              // max number of messages, returns the number dequeued
+		(*unsafe.Pointer)(queue.properties), // returns the message properties
+		queue.payloadType,                   // type descriptor of the payloads
+		(*unsafe.Pointer)(queue.payloads),   // returns the payloads
+		(*unsafe.Pointer)(queue.indicatorPointers), // returns the payload null indicators
+		(*unsafe.Pointer)(queue.ids),               // returns the message ids
+	)
+	conn.unwatchCancel(armed)
+
+	if result == C.OCI_ERROR {
+		// ORA-25228: timeout or end-of-fetch during message dequeue
+		errorCode, _ := conn.ociGetError()
+		if errorCode != 25228 {
+			err = conn.getError(result)
+			if ctx.Err() != nil {
+				return nil, ctx.Err()
+			}
+			return nil, fmt.Errorf("dequeue error: %v", err)
+		}
+	} else if result != C.OCI_SUCCESS && result != C.OCI_SUCCESS_WITH_INFO {
+		return nil, fmt.Errorf("dequeue error: %v", conn.getError(result))
+	}
+	if iters > C.ub4(max) {
+		iters = C.ub4(max)
+	}
+
+	messages := make([]Message, iters)
+	err = queue.readMessages(messages, true)
+	if err != nil {
+		return nil, err
+	}
+
+	return messages, nil
+}
+
+// readMessages sets the ID of messages from the message ids of the last enqueue or dequeue
+// and, when withPayloads is set, their payload and properties
+func (queue *Queue) readMessages(messages []Message, withPayloads bool) error {
+	if len(messages) == 0 {
+		return nil
+	}
+
+	conn := queue.conn
+	payloads := C.int(0)
+	if withPayloads {
+		payloads = 1
+	}
+	fields := queue.messageFields(len(messages))
+	result := C.ociAQMessagesGet(
+		conn.env,                            // environment handle
+		conn.errHandle,                      // error handle
+		C.ub4(len(messages)),                // number of messages
+		(*unsafe.Pointer)(queue.properties), // message properties descriptors
+		(*unsafe.Pointer)(queue.payloads),   // RAW payloads
+		(*unsafe.Pointer)(queue.ids),        // RAW message ids
+		payloads,                            // get payloads and properties too
+		&fields[0],                          // returns the ids, payloads, and properties
+	)
+	err := conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("get messages error: %v", err)
+	}
+
+	for i := range messages {
+		message := &messages[i]
+		message.ID = C.GoBytes(unsafe.Pointer(fields[i].id), C.int(fields[i].idLength))
+		if !withPayloads {
+			continue
+		}
+		message.Payload = C.GoBytes(unsafe.Pointer(fields[i].payload), C.int(fields[i].payloadLength))
+		message.Correlation = C.GoStringN((*C.char)(unsafe.Pointer(fields[i].correlation)), C.int(fields[i].correlationLength))
+		message.Priority = int(fields[i].priority)
+		message.Delay = time.Duration(fields[i].delay) * time.Second
+		message.Expiration = 0
+		if fields[i].expiration > 0 {
+			message.Expiration = time.Duration(fields[i].expiration) * time.Second
+		}
+		message.Attempts = int(fields[i].attempts)
+		message.EnqueueTime = time.Date(int(fields[i].enqueueYear), time.Month(fields[i].enqueueMonth), int(fields[i].enqueueDay),
+			int(fields[i].enqueueHour), int(fields[i].enqueueMinute), int(fields[i].enqueueSecond), 0, conn.timeLocation)
+	}
+
+	return nil
+}
+
+// Consume dequeues batches of up to batchSize messages and calls handler with each batch, in order,
+// until ctx is done or handler returns an error. Up to inFlight batches are dequeued ahead of the handler,
+// so dequeue round trips overlap with handling. Batches already dequeued when ctx is done are handled before
+// Consume returns ctx.Err(). When handler returns an error, Consume returns a *ConsumeError with the messages of its batch
+// and of the batches dequeued after it, which outside a transaction are no longer in the queue,
+// so with more than one batch in flight delivery is at most once.
+// As the dequeue runs on the connection of the queue while handler runs, handler must not use that connection.
+// In a transaction, batches are dequeued one at a time after the handler of the previous batch returns,
+// so batches dequeued ahead are not committed by handler and handler may use the connection.
+func (queue *Queue) Consume(ctx context.Context, batchSize int, inFlight int, handler func([]Message) error) error {
+	if queue.conn.inTransaction {
+		return queue.consumeInTransaction(ctx, batchSize, handler)
+	}
+	if inFlight < 1 {
+		inFlight = 1
+	}
+
+	dequeueCtx, cancel := context.WithCancel(ctx)
+	defer cancel()
+
+	batches := make(chan []Message, inFlight)
+	dequeueErr := make(chan error, 1)
+	go func() {
+		defer close(batches)
+		for {
+			messages, err := queue.DequeueBatch(dequeueCtx, batchSize)
+			if err != nil {
+				dequeueErr <- err
+				return
+			}
+			if len(messages) == 0 {
+				if queue.waitDeadline(dequeueCtx) {
+					dequeueErr <- dequeueCtx.Err()
+					return
+				}
+				continue
+			}
+			select {
+			case batches <- messages:
+			case <-dequeueCtx.Done():
+				batches <- messages
+				dequeueErr <- dequeueCtx.Err()
+				return
+			}
+		}
+	}()
+
+	for messages := range batches {
+		err := handler(messages)
+		if err != nil {
+			cancel()
+			consumeErr := &ConsumeError{Err: err, Messages: messages}
+			for batch := range batches {
+				consumeErr.Messages = append(consumeErr.Messages, batch...)
+			}
+			return consumeErr
+		}
+	}
+
+	return <-dequeueErr
+}
+
+// consumeInTransaction dequeues a batch and calls handler with it until ctx is done or handler returns an error
+func (queue *Queue) consumeInTransaction(ctx context.Context, batchSize int, handler func([]Message) error) error {
+	for {
+		messages, err := queue.DequeueBatch(ctx, batchSize)
+		if err != nil {
+			return err
+		}
+		if len(messages) == 0 {
+			if queue.waitDeadline(ctx) {
+				return ctx.Err()
+			}
+			continue
+		}
+		err = handler(messages)
+		if err != nil {
+			return &ConsumeError{Err: err, Messages: messages}
+		}
+	}
+}
+
+// waitDeadline waits for ctx to be done and returns true when its deadline is less than a second away,
+// as the dequeue wait is in whole seconds and would not wait anymore
+func (queue *Queue) waitDeadline(ctx context.Context) bool {
+	deadline, ok := ctx.Deadline()
+	if !ok || time.Until(deadline) >= time.Second {
+		return false
+	}
+	<-ctx.Done()
+	return true
+}
+
+// Error returns the error of the handler
+func (consumeErr *ConsumeError) Error() string {
+	return fmt.Sprintf("consume handler error: %v, %v messages not handled", consumeErr.Err, len(consumeErr.Messages))
+}
+
+// Unwrap returns the error of the handler
+func (consumeErr *ConsumeError) Unwrap() error {
+	return consumeErr.Err
+}
+
+// NewJSONMessage returns a message with value marshaled to JSON as its payload
+func NewJSONMessage(value interface{}) (Message, error) {
+	payload, err := json.Marshal(value)
+	if err != nil {
+		return Message{}, err
+	}
+	return Message{Payload: payload}, nil
+}
+
+// DecodeJSON unmarshals the JSON payload of the message into value
+func (message *Message) DecodeJSON(value interface{}) error {
+	return json.Unmarshal(message.Payload, value)
+}
+
+// Close frees the queue
+func (queue *Queue) Close() error {
+	if queue.closed {
+		return nil
+	}
+	queue.free()
+	return nil
+}
+
+// freeArrays frees the message arrays
+func (queue *Queue) freeArrays() {
+	if queue.capacity == 0 {
+		return
+	}
+
+	conn := queue.conn
+	count := queue.capacity
+	C.ociRawArrayFree(conn.env, conn.errHandle, C.ub4(count), (*unsafe.Pointer)(queue.payloads))
+	C.ociRawArrayFree(conn.env, conn.errHandle, C.ub4(count), (*unsafe.Pointer)(queue.ids))
+	properties := (*[1 << 28]unsafe.Pointer)(queue.properties)[:count:count]
+	for i := range properties {
+		C.OCIDescriptorFree(properties[i], C.OCI_DTYPE_AQMSG_PROPERTIES)
+	}
+	for _, buffer := range []unsafe.Pointer{queue.properties, queue.payloads, queue.ids, queue.indicators, queue.indicatorPointers, queue.fields} {
+		C.free(buffer)
+	}
+	queue.properties = nil
+	queue.payloads = nil
+	queue.ids = nil
+	queue.indicators = nil
+	queue.indicatorPointers = nil
+	queue.fields = nil
+	queue.capacity = 0
+}
+
+// free frees the message arrays, options, and name of the queue
+func (queue *Queue) free() {
+	queue.closed = true
+	queue.freeArrays()
+	if queue.enqueueOptions != nil {
+		C.OCIDescriptorFree(queue.enqueueOptions, C.OCI_DTYPE_AQENQ_OPTIONS)
+		queue.enqueueOptions = nil
+	}
+	if queue.dequeueOptions != nil {
+		C.OCIDescriptorFree(queue.dequeueOptions, C.OCI_DTYPE_AQDEQ_OPTIONS)
+		queue.dequeueOptions = nil
+	}
+	if queue.name != nil {
+		C.free(unsafe.Pointer(queue.name))
+		queue.name = nil
+	}
+}
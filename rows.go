@@ -4,9 +4,7 @@ package gobci
 import "C"
 
 import (
-	"bytes"
 	"database/sql/driver"
-	"encoding/binary"
 	"fmt"
 	"io"
 	"reflect"
@@ -22,7 +20,27 @@ func (rows *Rows) Close() error {
 
 	rows.closed = true
 
-	freeDefines(rows.defines)
+	rows.closeCursors()
+
+	for lob := range rows.lobs {
+		lob.Close()
+	}
+	for document := range rows.documents {
+		document.Close()
+	}
+
+	if rows.lobArena != nil {
+		C.free(rows.lobArena)
+		rows.lobArena = nil
+	}
+	rows.lobValues = nil
+
+	// buffers of cached statements are kept by the connection for the next run of the statement
+	if rows.stmt.cacheKey == "" || !rows.stmt.conn.putDefines(rows.stmt.cacheKey, rows.defines) {
+		freeDefines(rows.defines)
+	}
+
+	rows.releaseCursor()
 
 	return nil
 }
@@ -46,126 +64,183 @@ func (rows *Rows) Next(dest []driver.Value) error {
 		return rows.stmt.ctx.Err()
 	}
 
-	done := make(chan struct{})
-	defer close(done)
-	go rows.stmt.conn.ociBreakDone(rows.stmt.ctx, done)
-	result := C.OCIStmtFetch2(
-		rows.stmt.stmt,
-		rows.stmt.conn.errHandle,
-		1,
-		C.OCI_FETCH_NEXT,
-		0,
-		C.OCI_DEFAULT)
-	if result == C.OCI_NO_DATA {
-		return io.EOF
-	} else if result != C.OCI_SUCCESS && result != C.OCI_SUCCESS_WITH_INFO {
-		return rows.stmt.conn.getError(result)
+	if rows.index >= rows.fetched {
+		err := rows.fetch()
+		if err != nil {
+			return err
+		}
 	}
+	index := rows.index
+	rows.index++
 
 	for i := range dest {
-		if *rows.defines[i].indicator == -1 { // Null
+		define := &rows.defines[i]
+		pbuf := define.value(index)
+		length := (*[1 << 28]C.ub2)(unsafe.Pointer(define.length))[index]
+		indicator := (*[1 << 28]C.sb2)(unsafe.Pointer(define.indicator))[index]
+
+		if indicator == -1 { // Null
 			dest[i] = nil
 			continue
-		} else if *rows.defines[i].indicator != 0 {
-			return fmt.Errorf("unknown indicator %d for column %s", *rows.defines[i].indicator, rows.defines[i].name)
+		} else if indicator > 0 || indicator == -2 {
+			// the value was truncated, for example a LOB larger than lob_inline_size
+			return fmt.Errorf("value of column %s is larger than its buffer of %d bytes", define.name, define.maxSize)
+		} else if indicator != 0 {
+			return fmt.Errorf("unknown indicator %d for column %s", indicator, define.name)
+		}
+
+		var err error
+		dest[i], err = rows.decoders[i](pbuf, length)
+		if err != nil {
+			return err
+		}
+	}
+
+	return nil
+}
+
+// newRows returns rows for the defines of stmt with a decoder made for each column
+func newRows(stmt *Stmt, defines []defineStruct) *Rows {
+	rows := &Rows{}
+	rows.init(stmt, defines)
+	return rows
+}
+
+// init resets rows to read the result set of stmt from defines
+func (rows *Rows) init(stmt *Stmt, defines []defineStruct) {
+	*rows = Rows{
+		stmt:     stmt,
+		defines:  defines,
+		decoders: make([]columnDecoder, len(defines)),
+	}
+	for i := 0; i < len(defines); i++ {
+		rows.decoders[i] = rows.makeDecoder(i)
+	}
+	if hasLobColumn(defines) && !lobStreaming(stmt.ctx) {
+		rows.lobValues = make([][]driver.Value, len(defines))
+	}
+}
+
+// makeDecoder returns the function that converts a non null value of column i from its define buffer to a driver.Value.
+// It is chosen once per result set so Next does not switch on the data type of every cell.
+func (rows *Rows) makeDecoder(i int) columnDecoder {
+	define := &rows.defines[i]
+
+	// SQLT_BLOB and SQLT_CLOB as Lob, read on demand
+	if (define.dataType == C.SQLT_BLOB || define.dataType == C.SQLT_CLOB) && lobStreaming(rows.stmt.ctx) {
+		binary := define.dataType == C.SQLT_BLOB
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return rows.newLob(*(**C.OCILobLocator)(pbuf), binary)
 		}
+	}
+
+	switch define.dataType {
 
-		switch rows.defines[i].dataType {
-
-		// SQLT_DAT
-		case C.SQLT_DAT: // for test, date are return as timestamp
-			buf := (*[1 << 30]byte)(rows.defines[i].pbuf)[0:*rows.defines[i].length]
-			// TODO: Handle BCE dates (http://docs.oracle.com/cd/B12037_01/appdev.101/b10779/oci03typ.htm#438305)
-			// TODO: Handle timezones (http://docs.oracle.com/cd/B12037_01/appdev.101/b10779/oci03typ.htm#443601)
-			dest[i] = time.Date(
-				(int(buf[0])-100)*100+(int(buf[1])-100),
-				time.Month(int(buf[2])),
-				int(buf[3]),
-				int(buf[4])-1,
-				int(buf[5])-1,
-				int(buf[6])-1,
-				0,
-				rows.stmt.conn.timeLocation)
-
-		// SQLT_BLOB and SQLT_CLOB
-		case C.SQLT_BLOB, C.SQLT_CLOB:
-			lobLocator := (**C.OCILobLocator)(rows.defines[i].pbuf)
-			buffer, err := rows.stmt.conn.ociLobRead(*lobLocator, C.SQLCS_IMPLICIT)
+	// SQLT_DAT
+	case C.SQLT_DAT: // DATE, 7 bytes: century+100, year+100, month, day, hour+1, minute+1, second+1
+		location := rows.stmt.conn.timeLocation
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			value, err := decodeDate((*[1 << 16]byte)(pbuf)[:length:length], location)
 			if err != nil {
-				return err
+				return nil, fmt.Errorf("%v for column %v", err, i)
 			}
+			return value, nil
+		}
 
-			// set dest to buffer
-			if rows.defines[i].dataType == C.SQLT_BLOB {
-				dest[i] = buffer
-			} else {
-				dest[i] = string(buffer)
+	// SQLT_BLOB
+	case C.SQLT_BLOB:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			if rows.lobValues != nil {
+				// read for the whole fetched batch by readLobs, Next has already moved index past the current row
+				return rows.lobValues[i][rows.index-1], nil
 			}
+			return rows.stmt.conn.ociLobRead(*(**C.OCILobLocator)(pbuf), C.SQLCS_IMPLICIT)
+		}
 
-		// SQLT_CHR, SQLT_STR, SQLT_AFC, SQLT_AVC, and SQLT_LNG
-		case C.SQLT_CHR, C.SQLT_STR, C.SQLT_AFC, C.SQLT_AVC, C.SQLT_LNG:
-			dest[i] = C.GoStringN((*C.char)(rows.defines[i].pbuf), C.int(*rows.defines[i].length))
-
-		// SQLT_BIN
-		case C.SQLT_BIN: // RAW
-			buf := (*[1 << 30]byte)(rows.defines[i].pbuf)[0:*rows.defines[i].length]
-			dest[i] = buf
-
-		// SQLT_NUM
-		case C.SQLT_NUM: // NUMBER
-			buf := (*[21]byte)(rows.defines[i].pbuf)[0:*rows.defines[i].length]
-			dest[i] = buf
-
-		// SQLT_VNU
-		case C.SQLT_VNU: // VARNUM
-			buf := (*[22]byte)(rows.defines[i].pbuf)[0:*rows.defines[i].length]
-			dest[i] = buf
-
-		// SQLT_INT
-		case C.SQLT_INT: // INT
-			buf := (*[8]byte)(rows.defines[i].pbuf)[0:*rows.defines[i].length]
-			var data int64
-			err := binary.Read(bytes.NewReader(buf), binary.LittleEndian, &data)
+	// SQLT_CLOB
+	case C.SQLT_CLOB:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			if rows.lobValues != nil {
+				// read for the whole fetched batch by readLobs, Next has already moved index past the current row
+				return rows.lobValues[i][rows.index-1], nil
+			}
+			buffer, err := rows.stmt.conn.ociLobRead(*(**C.OCILobLocator)(pbuf), C.SQLCS_IMPLICIT)
 			if err != nil {
-				return fmt.Errorf("binary read for column %v - error: %v", i, err)
+				return nil, err
 			}
-			dest[i] = data
+			return string(buffer), nil
+		}
 
-		// SQLT_BDOUBLE
-		case C.SQLT_BDOUBLE: // native double
-			buf := (*[8]byte)(rows.defines[i].pbuf)[0:*rows.defines[i].length]
-			var data float64
-			err := binary.Read(bytes.NewReader(buf), binary.LittleEndian, &data)
-			if err != nil {
-				return fmt.Errorf("binary read for column %v - error: %v", i, err)
+	// SQLT_CHR, SQLT_STR, SQLT_AFC, SQLT_AVC, and SQLT_LNG
+	case C.SQLT_CHR, C.SQLT_STR, C.SQLT_AFC, C.SQLT_AVC, C.SQLT_LNG:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return string((*[1 << 30]byte)(pbuf)[0:length:length]), nil
+		}
+
+	// SQLT_BIN
+	case C.SQLT_BIN: // RAW
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return (*[1 << 30]byte)(pbuf)[0:length:length], nil
+		}
+
+	// SQLT_NUM
+	case C.SQLT_NUM: // NUMBER
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return decodeNumber((*[21]byte)(pbuf)[0:length])
+		}
+
+	// SQLT_VNU
+	case C.SQLT_VNU: // VARNUM, the first byte is the length of the number
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			buffer := (*[22]byte)(pbuf)
+			if buffer[0] > 21 {
+				return nil, fmt.Errorf("invalid VARNUM length %v", buffer[0])
 			}
-			dest[i] = data
+			return decodeNumber(buffer[1 : 1+buffer[0]])
+		}
+
+	// SQLT_INT
+	case C.SQLT_INT: // INT, defined as 8 bytes native int
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return int64(*(*C.sb8)(pbuf)), nil
+		}
 
-		// SQLT_TIMESTAMP
-		case C.SQLT_TIMESTAMP:
-			aTime, err := rows.stmt.conn.ociDateTimeToTime(*(**C.OCIDateTime)(rows.defines[i].pbuf), false)
+	// SQLT_BDOUBLE
+	case C.SQLT_BDOUBLE: // native double
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return float64(*(*C.double)(pbuf)), nil
+		}
+
+	// SQLT_TIMESTAMP
+	case C.SQLT_TIMESTAMP:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			aTime, err := rows.stmt.conn.ociDateTimeToTime(*(**C.OCIDateTime)(pbuf), false)
 			if err != nil {
-				return fmt.Errorf("ociDateTimeToTime for column %v - error: %v", i, err)
+				return nil, fmt.Errorf("ociDateTimeToTime for column %v - error: %v", i, err)
 			}
-			dest[i] = *aTime
+			return *aTime, nil
+		}
 
-		// SQLT_TIMESTAMP_TZ and SQLT_TIMESTAMP_LTZ
-		case C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ:
-			aTime, err := rows.stmt.conn.ociDateTimeToTime(*(**C.OCIDateTime)(rows.defines[i].pbuf), true)
+	// SQLT_TIMESTAMP_TZ and SQLT_TIMESTAMP_LTZ
+	case C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			aTime, err := rows.stmt.conn.ociDateTimeToTime(*(**C.OCIDateTime)(pbuf), true)
 			if err != nil {
-				return fmt.Errorf("ociDateTimeToTime for column %v - error: %v", i, err)
+				return nil, fmt.Errorf("ociDateTimeToTime for column %v - error: %v", i, err)
 			}
-			dest[i] = *aTime
+			return *aTime, nil
+		}
 
-		// SQLT_INTERVAL_DS
-		case C.SQLT_INTERVAL_DS:
+	// SQLT_INTERVAL_DS
+	case C.SQLT_INTERVAL_DS:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
 			var days C.sb4
 			var hours C.sb4
 			var minutes C.sb4
 			var seconds C.sb4
 			var fracSeconds C.sb4
-			interval := *(**C.OCIInterval)(rows.defines[i].pbuf)
-			result = C.OCIIntervalGetDaySecond(
+			interval := *(**C.OCIInterval)(pbuf)
+			result := C.OCIIntervalGetDaySecond(
 				unsafe.Pointer(rows.stmt.conn.env), // environment handle
 				rows.stmt.conn.errHandle,           // error handle
 				&days,                              // days
@@ -176,18 +251,20 @@ func (rows *Rows) Next(dest []driver.Value) error {
 				interval,                           // interval
 			)
 			if result != C.OCI_SUCCESS {
-				return rows.stmt.conn.getError(result)
+				return nil, rows.stmt.conn.getError(result)
 			}
 
-			dest[i] = (int64(days) * 24 * int64(time.Hour)) + (int64(hours) * int64(time.Hour)) +
-				(int64(minutes) * int64(time.Minute)) + (int64(seconds) * int64(time.Second)) + int64(fracSeconds)
+			return (int64(days) * 24 * int64(time.Hour)) + (int64(hours) * int64(time.Hour)) +
+				(int64(minutes) * int64(time.Minute)) + (int64(seconds) * int64(time.Second)) + int64(fracSeconds), nil
+		}
 
-		// SQLT_INTERVAL_YM
-		case C.SQLT_INTERVAL_YM:
+	// SQLT_INTERVAL_YM
+	case C.SQLT_INTERVAL_YM:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
 			var years C.sb4
 			var months C.sb4
-			interval := *(**C.OCIInterval)(rows.defines[i].pbuf)
-			result = C.OCIIntervalGetYearMonth(
+			interval := *(**C.OCIInterval)(pbuf)
+			result := C.OCIIntervalGetYearMonth(
 				unsafe.Pointer(rows.stmt.conn.env), // environment handle
 				rows.stmt.conn.errHandle,           // error handle
 				&years,                             // year
@@ -195,37 +272,121 @@ func (rows *Rows) Next(dest []driver.Value) error {
 				interval,                           // interval
 			)
 			if result != C.OCI_SUCCESS {
-				return rows.stmt.conn.getError(result)
-			}
-			dest[i] = (int64(years) * 12) + int64(months)
-
-		// SQLT_RSET - ref cursor
-		case C.SQLT_RSET:
-			stmtP := (**C.OCIStmt)(rows.defines[i].pbuf)
-			subStmt := &Stmt{conn: rows.stmt.conn, stmt: *stmtP, ctx: rows.stmt.ctx, releaseMode: C.ub4(C.OCI_DEFAULT)}
-			if rows.defines[i].subDefines == nil {
-				var err error
-				rows.defines[i].subDefines, err = subStmt.makeDefines()
-				if err != nil {
-					return err
-				}
+				return nil, rows.stmt.conn.getError(result)
 			}
-			subRows := &Rows{
-				stmt:    subStmt,
-				defines: rows.defines[i].subDefines,
+			return (int64(years) * 12) + int64(months), nil
+		}
+
+	// SQLT_JSON - native JSON, converted to text in the client
+	case C.SQLT_JSON:
+		if jsonStreaming(rows.stmt.ctx) {
+			return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+				return rows.newJSONDocument(*(**C.OCIJson)(pbuf))
 			}
-			dest[i] = subRows
+		}
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return rows.stmt.conn.ociJSONToText(*(**C.OCIJson)(pbuf))
+		}
+
+	// SQLT_RSET - ref cursor
+	case C.SQLT_RSET:
+		return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+			return rows.newCursorRows((*unsafe.Pointer)(pbuf))
+		}
+
+	}
+
+	// default
+	dataType := define.dataType
+	return func(pbuf unsafe.Pointer, length C.ub2) (driver.Value, error) {
+		return nil, fmt.Errorf("Unhandled column type: %d", dataType)
+	}
+}
+
+// fetch calls OCIStmtFetch2 to fill the defines buffers with the next batch of rows
+func (rows *Rows) fetch() error {
+	if rows.endOfFetch {
+		return io.EOF
+	}
+
+	arraySize := 1
+	if len(rows.defines) > 0 {
+		arraySize = rows.defines[0].arraySize
+	}
+
+	if rows.prefetchRows > 0 && rows.prefetchRows < rows.prefetchMax && rows.prefetchUsed >= rows.prefetchRows {
+		// the prefetched rows have been used, so the next round trip prefetches twice as many
+		rows.prefetchRows *= 2
+		if rows.prefetchRows > rows.prefetchMax {
+			rows.prefetchRows = rows.prefetchMax
+		}
+		rows.prefetchUsed = 0
+		err := rows.stmt.setPrefetch(rows.prefetchRows, 0)
+		if err != nil {
+			return err
+		}
+	}
 
-		// default
-		default:
-			return fmt.Errorf("Unhandled column type: %d", rows.defines[i].dataType)
+	// the fetch reuses the REF CURSOR handles in the define buffers
+	rows.closeCursors()
+
+	armed := rows.stmt.conn.watchCancel(rows.stmt.ctx)
+	result := C.OCIStmtFetch2(
+		rows.stmt.stmt,
+		rows.stmt.conn.errHandle,
+		C.ub4(arraySize),
+		C.OCI_FETCH_NEXT,
+		0,
+		C.OCI_DEFAULT)
+	rows.stmt.conn.unwatchCancel(armed)
+	if result == C.OCI_NO_DATA {
+		// OCI_NO_DATA is also returned when fewer rows than the array size were fetched
+		rows.endOfFetch = true
+	} else if result != C.OCI_SUCCESS && result != C.OCI_SUCCESS_WITH_INFO {
+		// the select-list may have changed, so describe it again next time
+		rows.stmt.conn.dropDefines(rows.stmt.cacheKey)
+		return rows.stmt.conn.getError(result)
+	}
 
+	rows.index = 0
+	rows.fetched = 0
+	if arraySize == 1 {
+		if !rows.endOfFetch {
+			rows.fetched = 1
+		}
+	} else {
+		var rowsFetched C.ub4
+		_, err := rows.stmt.ociAttrGet(unsafe.Pointer(&rowsFetched), C.OCI_ATTR_ROWS_FETCHED)
+		if err != nil {
+			return err
+		}
+		rows.fetched = int(rowsFetched)
+	}
+
+	rows.prefetchUsed += rows.fetched
+
+	if rows.fetched == 0 {
+		return io.EOF
+	}
+
+	if rows.lobValues != nil {
+		err := rows.readLobs()
+		if err == errLobArrayReadUnsupported {
+			// fall back to reading each LOB when it is decoded
+			rows.lobValues = nil
+		} else if err != nil {
+			return err
 		}
 	}
 
 	return nil
 }
 
+// value returns a pointer to the buffer of row index
+func (define *defineStruct) value(index int) unsafe.Pointer {
+	return unsafe.Pointer(uintptr(define.pbuf) + uintptr(index)*uintptr(define.maxSize))
+}
+
 // ColumnTypeDatabaseTypeName implement RowsColumnTypeDatabaseTypeName.
 func (rows *Rows) ColumnTypeDatabaseTypeName(i int) string {
 	if len(rows.defines) < i+1 {
@@ -299,6 +460,8 @@ func (rows *Rows) ColumnTypeDatabaseTypeName(i int) string {
 		return "SQLT_INTERVAL_DS"
 	case C.SQLT_TIMESTAMP_LTZ:
 		return "SQLT_TIMESTAMP_LTZ"
+	case C.SQLT_JSON:
+		return "SQLT_JSON"
 	}
 	return ""
 }
@@ -323,14 +486,24 @@ func (rows *Rows) ColumnTypeScanType(i int) reflect.Type {
 		return typeNil
 	}
 
+	if (rows.defines[i].dataType == C.SQLT_BLOB || rows.defines[i].dataType == C.SQLT_CLOB) && lobStreaming(rows.stmt.ctx) {
+		return typeLob
+	}
+	if rows.defines[i].dataType == C.SQLT_JSON && jsonStreaming(rows.stmt.ctx) {
+		return typeJSONDocument
+	}
+
 	switch rows.defines[i].dataType {
 	case C.SQLT_AFC, C.SQLT_CHR, C.SQLT_VCS, C.SQLT_AVC, C.SQLT_CLOB, C.SQLT_RDD:
 		return typeString
-	case C.SQLT_BIN, C.SQLT_BLOB:
+	case C.SQLT_NUM, C.SQLT_VNU:
+		// int64 or string, string scans into both
+		return typeString
+	case C.SQLT_BIN, C.SQLT_BLOB, C.SQLT_JSON:
 		return typeSliceByte
 	case C.SQLT_INT:
 		return typeInt64
-	case C.SQLT_BDOUBLE, C.SQLT_IBDOUBLE, C.SQLT_BFLOAT, C.SQLT_IBFLOAT, C.SQLT_NUM:
+	case C.SQLT_BDOUBLE, C.SQLT_IBDOUBLE, C.SQLT_BFLOAT, C.SQLT_IBFLOAT:
 		return typeFloat64
 	case C.SQLT_TIMESTAMP, C.SQLT_DAT, C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ:
 		return typeTime
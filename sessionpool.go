@@ -0,0 +1,187 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"fmt"
+	"sync"
+	"unsafe"
+)
+
+type (
+	// sessionPoolStruct is an OCI session pool shared by all connections opened with the same pooled DSN
+	sessionPoolStruct struct {
+		spool         *C.OCISPool
+		authInfo      *C.OCIAuthInfo
+		name          *C.OraText
+		nameLength    C.ub4
+		stmtCacheSize C.ub4
+	}
+
+	// sessionPoolKey is the key of a shared session pool
+	sessionPoolKey struct {
+		environment   *environmentStruct
+		connect       string
+		username      string
+		password      string
+		poolMin       C.ub4
+		poolMax       C.ub4
+		poolIncr      C.ub4
+		stmtCacheSize C.ub4
+	}
+)
+
+var (
+	sessionPoolsMutex sync.Mutex
+	sessionPools      = make(map[sessionPoolKey]*sessionPoolStruct)
+)
+
+// getSessionPool returns the shared session pool for dsn, creating it if needed.
+// Shared session pools live for the life of the process.
+// Errors are reported through the error handle of conn.
+func (conn *Conn) getSessionPool(dsn *DSN) (*sessionPoolStruct, error) {
+	key := sessionPoolKey{
+		environment:   conn.environment,
+		connect:       dsn.Connect,
+		username:      dsn.Username,
+		password:      dsn.Password,
+		poolMin:       dsn.poolMin,
+		poolMax:       dsn.poolMax,
+		poolIncr:      dsn.poolIncr,
+		stmtCacheSize: dsn.stmtCacheSize,
+	}
+
+	sessionPoolsMutex.Lock()
+	defer sessionPoolsMutex.Unlock()
+
+	if sessionPool, ok := sessionPools[key]; ok {
+		return sessionPool, nil
+	}
+
+	sessionPool := &sessionPoolStruct{stmtCacheSize: dsn.stmtCacheSize}
+
+	handle, _, err := conn.ociHandleAlloc(C.OCI_HTYPE_SPOOL, 0)
+	if err != nil {
+		return nil, fmt.Errorf("allocate session pool handle error: %v", err)
+	}
+	sessionPool.spool = (*C.OCISPool)(*handle)
+
+	connectString := cString(dsn.Connect)
+	defer C.free(unsafe.Pointer(connectString))
+	username := cString(dsn.Username)
+	defer C.free(unsafe.Pointer(username))
+	password := cString(dsn.Password)
+	defer C.free(unsafe.Pointer(password))
+
+	mode := C.ub4(C.OCI_SPC_HOMOGENEOUS)
+	if dsn.stmtCacheSize > 0 {
+		mode |= C.OCI_SPC_STMTCACHE
+	}
+
+	result := C.OCISessionPoolCreate(
+		conn.env,                 // environment handle
+		conn.errHandle,           // error handle
+		sessionPool.spool,        // session pool handle
+		&sessionPool.name,        // returns the name of the session pool, used by OCISessionGet
+		&sessionPool.nameLength,  // returns the length of the pool name
+		connectString,            // the TNS alias of the database to connect to
+		C.ub4(len(dsn.Connect)),  // the length of connStr
+		dsn.poolMin,              // the minimum number of sessions in the session pool
+		dsn.poolMax,              // the maximum number of sessions in the session pool
+		dsn.poolIncr,             // the next increment for sessions to be started if the current number of sessions is less than sessMax
+		username,                 // the user name of a homogeneous session pool
+		C.ub4(len(dsn.Username)), // the length of userid
+		password,                 // the password of a homogeneous session pool
+		C.ub4(len(dsn.Password)), // the length of password
+		mode,                     // the modes: OCI_SPC_HOMOGENEOUS, OCI_SPC_STMTCACHE
+	)
+	if result != C.OCI_SUCCESS && result != C.OCI_SUCCESS_WITH_INFO {
+		err = conn.getError(result)
+		C.OCIHandleFree(unsafe.Pointer(sessionPool.spool), C.OCI_HTYPE_SPOOL)
+		return nil, err
+	}
+
+	if dsn.stmtCacheSize > 0 {
+		stmtCacheSize := dsn.stmtCacheSize
+		err = conn.ociAttrSet(unsafe.Pointer(sessionPool.spool), C.OCI_HTYPE_SPOOL, unsafe.Pointer(&stmtCacheSize), 0, C.OCI_ATTR_SPOOL_STMTCACHESIZE)
+		if err != nil {
+			C.OCISessionPoolDestroy(sessionPool.spool, conn.errHandle, C.OCI_DEFAULT)
+			C.OCIHandleFree(unsafe.Pointer(sessionPool.spool), C.OCI_HTYPE_SPOOL)
+			return nil, fmt.Errorf("session pool stmt cache size attribute set error: %v", err)
+		}
+	}
+
+	// auth info handle used by OCISessionGet to get sessions from the homogeneous pool
+	handle, _, err = conn.ociHandleAlloc(C.OCI_HTYPE_AUTHINFO, 0)
+	if err != nil {
+		C.OCISessionPoolDestroy(sessionPool.spool, conn.errHandle, C.OCI_DEFAULT)
+		C.OCIHandleFree(unsafe.Pointer(sessionPool.spool), C.OCI_HTYPE_SPOOL)
+		return nil, fmt.Errorf("allocate auth info handle error: %v", err)
+	}
+	sessionPool.authInfo = (*C.OCIAuthInfo)(*handle)
+
+	sessionPools[key] = sessionPool
+
+	return sessionPool, nil
+}
+
+// sessionGet gets a session from the shared session pool of dsn and sets it as the service context of conn
+func (conn *Conn) sessionGet(dsn *DSN) error {
+	sessionPool, err := conn.getSessionPool(dsn)
+	if err != nil {
+		return err
+	}
+
+	mode := C.ub4(C.OCI_SESSGET_SPOOL)
+	if sessionPool.stmtCacheSize > 0 {
+		// statement cache of the pooled session is used by OCIStmtPrepare2
+		mode |= C.OCI_SESSGET_STMTCACHE
+	}
+
+	var svc *C.OCISvcCtx
+	result := C.OCISessionGet(
+		conn.env,               // environment handle
+		conn.errHandle,         // error handle
+		&svc,                   // returns the service context of the session
+		sessionPool.authInfo,   // auth info handle
+		sessionPool.name,       // name of the session pool returned by OCISessionPoolCreate
+		sessionPool.nameLength, // length of poolName
+		nil,                    // tag of the session to get
+		0,                      // length of tagInfo
+		nil,                    // returns the tag of the session
+		nil,                    // length of retTagInfo
+		nil,                    // returns true if a session with the tag was found
+		mode,                   // mode: OCI_SESSGET_SPOOL, OCI_SESSGET_STMTCACHE
+	)
+	if result != C.OCI_SUCCESS && result != C.OCI_SUCCESS_WITH_INFO {
+		return conn.getError(result)
+	}
+
+	conn.svc = svc
+	conn.sessionPool = sessionPool
+
+	return nil
+}
+
+// sessionRelease releases the session of conn back to the session pool.
+// A session that returned a bad connection error is dropped from the pool instead.
+func (conn *Conn) sessionRelease() error {
+	mode := C.ub4(C.OCI_DEFAULT)
+	if conn.badConnection {
+		mode = C.OCI_SESSRLS_DROPSESS
+	}
+
+	result := C.OCISessionRelease(
+		conn.svc,       // service context of the session
+		conn.errHandle, // error handle
+		nil,            // tag of the session
+		0,              // length of tag
+		mode,           // mode: OCI_DEFAULT or OCI_SESSRLS_DROPSESS
+	)
+
+	conn.svc = nil
+	conn.sessionPool = nil
+
+	return conn.getError(result)
+}
@@ -22,6 +22,9 @@ func (stmt *Stmt) Close() error {
 	}
 	stmt.closed = true
 
+	freeBinds(stmt.binds)
+	stmt.binds = nil
+
 	var result C.sword
 	if stmt.cacheKey == "" {
 		result = C.OCIStmtRelease(
@@ -57,7 +60,7 @@ func (stmt *Stmt) NumInput() int {
 // CheckNamedValue checks a named value
 func (stmt *Stmt) CheckNamedValue(namedValue *driver.NamedValue) error {
 	switch namedValue.Value.(type) {
-	case sql.Out:
+	case sql.Out, StreamValue, *StreamValue, JSON, *JSON:
 		return nil
 	}
 	return driver.ErrSkip
@@ -65,6 +68,7 @@ func (stmt *Stmt) CheckNamedValue(namedValue *driver.NamedValue) error {
 
 // bindValues binds the values to the stmt
 func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedValue) ([]bindStruct, error) {
+	stmt.streams = nil
 	if len(values) == 0 && len(namedValues) == 0 {
 		return nil, nil
 	}
@@ -97,9 +101,31 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 			valueInterface = namedValues[i].Value
 		}
 
+		var name string
+		if !useValues {
+			name = namedValues[i].Name
+		}
+
 		var isOut bool
 		var isNill bool
 		sbind.out, isOut = valueInterface.(sql.Out)
+		if !isOut {
+			var kept bool
+			kept, err = stmt.bindKept(i, name, valueInterface)
+			if err != nil {
+				binds = append(binds, sbind)
+				freeBinds(binds)
+				return nil, err
+			}
+			if kept {
+				C.free(unsafe.Pointer(sbind.length))
+				C.free(unsafe.Pointer(sbind.indicator))
+				continue
+			}
+		}
+		// this execution binds its own buffer to the placeholder
+		stmt.freeKeptBind(i)
+
 		if isOut {
 			valueInterface, err = driver.DefaultParameterConverter.ConvertValue(sbind.out.Dest)
 			if err != nil {
@@ -126,6 +152,29 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 
 		switch value := valueInterface.(type) {
 
+		case StreamValue, *StreamValue:
+			if isOut {
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("StreamValue can not be used with sql.Out for column %v", i)
+			}
+			stream, _ := value.(StreamValue)
+			if streamP, ok := value.(*StreamValue); ok && streamP != nil {
+				stream = *streamP
+			}
+			if stream.Reader == nil {
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("StreamValue has no Reader for column %v", i)
+			}
+			sbind.stream = newStreamBind(stream)
+			binds = append(binds, sbind)
+			err = stmt.ociBindStream(C.ub4(i+1), name, &binds[len(binds)-1])
+			if err != nil {
+				freeBinds(binds)
+				return nil, err
+			}
+			stmt.streams = append(stmt.streams, binds[len(binds)-1].stream)
+			continue
+
 		case nil:
 			sbind.dataType = C.SQLT_AFC
 			sbind.pbuf = nil
@@ -136,25 +185,9 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 			if isOut {
 
 				if len(value) > 32767 {
-					var lobP *unsafe.Pointer
-					lobP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_LOB, 0)
+					err = stmt.bindTemporaryLob(&sbind, C.SQLT_BLOB, C.OCI_TEMP_BLOB, value)
 					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					sbind.dataType = C.SQLT_BLOB
-					sbind.pbuf = unsafe.Pointer(lobP)
-					sbind.maxSize = C.sb4(sizeOfNilPointer)
-					*sbind.length = C.ub2(sizeOfNilPointer)
-					lobLocator := (**C.OCILobLocator)(sbind.pbuf)
-					err = stmt.conn.ociLobCreateTemporary(*lobLocator, C.SQLCS_IMPLICIT, C.OCI_TEMP_BLOB)
-					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					err = stmt.conn.ociLobWrite(*lobLocator, C.SQLCS_IMPLICIT, value)
-					if err != nil {
-						freeBinds(binds)
+						freeBinds(append(binds, sbind))
 						return nil, err
 					}
 				} else {
@@ -171,25 +204,9 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 			} else {
 
 				if len(value) > 32767 {
-					var lobP *unsafe.Pointer
-					lobP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_LOB, 0)
-					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					sbind.dataType = C.SQLT_BLOB
-					sbind.pbuf = unsafe.Pointer(lobP)
-					sbind.maxSize = C.sb4(sizeOfNilPointer)
-					*sbind.length = C.ub2(sizeOfNilPointer)
-					lobLocator := (**C.OCILobLocator)(sbind.pbuf)
-					err = stmt.conn.ociLobCreateTemporary(*lobLocator, C.SQLCS_IMPLICIT, C.OCI_TEMP_BLOB)
+					err = stmt.bindTemporaryLob(&sbind, C.SQLT_BLOB, C.OCI_TEMP_BLOB, value)
 					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					err = stmt.conn.ociLobWrite(*lobLocator, C.SQLCS_IMPLICIT, value)
-					if err != nil {
-						freeBinds(binds)
+						freeBinds(append(binds, sbind))
 						return nil, err
 					}
 				} else {
@@ -202,41 +219,35 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 			}
 
 		case time.Time:
+			if !isOut && stmt.conn.dateBindable(&value) {
+				sbind.dataType = C.SQLT_DAT
+				sbind.maxSize = 7
+				*sbind.length = 7
+				sbind.pbuf = C.malloc(7)
+				stmt.conn.encodeDate((*[7]byte)(sbind.pbuf)[:], &value)
+				break
+			}
+
 			sbind.dataType = C.SQLT_TIMESTAMP_TZ
 			sbind.maxSize = C.sb4(sizeOfNilPointer)
 			*sbind.length = C.ub2(sizeOfNilPointer)
+			sbind.pbuf = C.malloc(C.size_t(sizeOfNilPointer))
+			sbind.dateTimes = stmt.conn.environment
 
-			dateTimePP, err := stmt.conn.timeToOCIDateTime(&value)
+			dateTimeP, err := stmt.conn.timeToPooledDateTime(&value)
+			*(*unsafe.Pointer)(sbind.pbuf) = dateTimeP
 			if err != nil {
-				freeBinds(binds)
-				return nil, fmt.Errorf("timeToOCIDateTime for column %v - error: %v", i, err)
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("timeToPooledDateTime for column %v - error: %v", i, err)
 			}
 
-			sbind.pbuf = unsafe.Pointer(dateTimePP)
-
 		case string:
 			if isOut {
 
 				if len(value) > 32767 {
-					var lobP *unsafe.Pointer
-					lobP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_LOB, 0)
+					err = stmt.bindTemporaryLob(&sbind, C.SQLT_CLOB, C.OCI_TEMP_CLOB, []byte(value))
 					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					sbind.dataType = C.SQLT_CLOB
-					sbind.pbuf = unsafe.Pointer(lobP)
-					sbind.maxSize = C.sb4(sizeOfNilPointer)
-					*sbind.length = C.ub2(sizeOfNilPointer)
-					lobLocator := (**C.OCILobLocator)(sbind.pbuf)
-					err = stmt.conn.ociLobCreateTemporary(*lobLocator, C.SQLCS_IMPLICIT, C.OCI_TEMP_CLOB)
-					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					err = stmt.conn.ociLobWrite(*lobLocator, C.SQLCS_IMPLICIT, []byte(value))
-					if err != nil {
-						freeBinds(binds)
+						freeBinds(append(binds, sbind))
 						return nil, err
 					}
 				} else {
@@ -253,25 +264,9 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 			} else {
 
 				if len(value) > 32767 {
-					var lobP *unsafe.Pointer
-					lobP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_LOB, 0)
-					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					sbind.dataType = C.SQLT_CLOB
-					sbind.pbuf = unsafe.Pointer(lobP)
-					sbind.maxSize = C.sb4(sizeOfNilPointer)
-					*sbind.length = C.ub2(sizeOfNilPointer)
-					lobLocator := (**C.OCILobLocator)(sbind.pbuf)
-					err = stmt.conn.ociLobCreateTemporary(*lobLocator, C.SQLCS_IMPLICIT, C.OCI_TEMP_CLOB)
-					if err != nil {
-						freeBinds(binds)
-						return nil, err
-					}
-					err = stmt.conn.ociLobWrite(*lobLocator, C.SQLCS_IMPLICIT, []byte(value))
+					err = stmt.bindTemporaryLob(&sbind, C.SQLT_CLOB, C.OCI_TEMP_CLOB, []byte(value))
 					if err != nil {
-						freeBinds(binds)
+						freeBinds(append(binds, sbind))
 						return nil, err
 					}
 				} else {
@@ -313,6 +308,37 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 				*sbind.indicator = -1 // set to null
 			}
 
+		case JSON, *JSON:
+			if isOut {
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("JSON can not be used with sql.Out for column %v", i)
+			}
+			jsonValue, _ := value.(JSON)
+			if jsonP, ok := value.(*JSON); ok && jsonP != nil {
+				jsonValue = *jsonP
+			}
+			err = stmt.bindJSON(&sbind, jsonValue)
+			if err != nil {
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("JSON for column %v - error: %v", i, err)
+			}
+
+		case *driver.Rows:
+			if !isOut {
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("*driver.Rows can only be bound with sql.Out for column %v", i)
+			}
+			// REF CURSOR out bind, returned as rows by outputBoundParameters
+			var handle *unsafe.Pointer
+			handle, _, err = stmt.conn.ociHandleAlloc(C.OCI_HTYPE_STMT, 0)
+			if err != nil {
+				freeBinds(append(binds, sbind))
+				return nil, fmt.Errorf("allocate ref cursor handle for column %v - error: %v", i, err)
+			}
+			sbind.dataType = C.SQLT_RSET
+			sbind.pbuf = unsafe.Pointer(handle)
+			sbind.maxSize = 0
+
 		case bool: // oracle does not have bool, handle as 0/1 int
 			sbind.dataType = C.SQLT_INT
 			if value {
@@ -346,11 +372,11 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 		// add to binds now so if error will be freed by freeBinds call
 		binds = append(binds, sbind)
 
-		if useValues || len(namedValues[i].Name) < 1 {
+		if len(name) < 1 {
 			err = stmt.ociBindByPos(C.ub4(i+1), &sbind)
 			// TODO: should we use namedValues[i]Ordinal?
 		} else {
-			err = stmt.ociBindByName([]byte(":"+namedValues[i].Name), &sbind)
+			err = stmt.ociBindByName([]byte(":"+name), &sbind)
 		}
 		if err != nil {
 			freeBinds(binds)
@@ -362,6 +388,181 @@ func (stmt *Stmt) bindValues(values []driver.Value, namedValues []driver.NamedVa
 	return binds, nil
 }
 
+// bindKept binds an input value using the buffer kept by the statement for the placeholder at position.
+// When the data type, name, and buffer capacity are unchanged, the value is only copied into the existing C memory
+// and the placeholder is not bound again. Otherwise the buffer is grown and the placeholder is bound again.
+// Returns false for values that need a buffer per execution: time.Time, StreamValue, JSON, and values larger than 32767 bytes.
+func (stmt *Stmt) bindKept(position int, name string, value interface{}) (bool, error) {
+	var dataType C.ub2
+	var size int
+
+	switch aValue := value.(type) {
+	case nil:
+		dataType = C.SQLT_AFC
+	case string:
+		if len(aValue) > 32767 {
+			return false, nil
+		}
+		dataType = C.SQLT_AFC
+		size = len(aValue)
+	case []byte:
+		if len(aValue) > 32767 {
+			return false, nil
+		}
+		dataType = C.SQLT_BIN
+		size = len(aValue)
+	case int, int8, int16, int32, int64, uint, uint8, uint16, uint32, uint64, uintptr, bool:
+		dataType = C.SQLT_INT
+		size = 8
+	case float32, float64:
+		dataType = C.SQLT_BDOUBLE
+		size = 8
+	case time.Time, StreamValue, *StreamValue, JSON, *JSON:
+		return false, nil
+	default:
+		d := fmt.Sprintf("%v", value)
+		if len(d) > 32767 {
+			return false, nil
+		}
+		value = d
+		dataType = C.SQLT_AFC
+		size = len(d)
+	}
+
+	for len(stmt.binds) <= position {
+		stmt.binds = append(stmt.binds, bindStruct{})
+	}
+	bind := &stmt.binds[position]
+
+	rebind := bind.bindHandle == nil || bind.dataType != dataType || int(bind.maxSize) < size || bind.name != name
+	if rebind {
+		stmt.freeKeptBind(position)
+		bind.dataType = dataType
+		bind.maxSize = keptBindCapacity(dataType, size)
+		bind.name = name
+		bind.pbuf = C.malloc(C.size_t(bind.maxSize))
+		bind.length = (*C.ub2)(C.malloc(C.sizeof_ub2))
+		bind.indicator = (*C.sb2)(C.malloc(C.sizeof_sb2))
+	}
+
+	*bind.indicator = 0
+	*bind.length = C.ub2(size)
+
+	switch aValue := value.(type) {
+	case nil:
+		*bind.indicator = -1 // set to null
+		*bind.length = 0
+	case string:
+		copy((*[1 << 30]byte)(bind.pbuf)[:bind.maxSize:bind.maxSize], aValue)
+	case []byte:
+		copy((*[1 << 30]byte)(bind.pbuf)[:bind.maxSize:bind.maxSize], aValue)
+	case float32:
+		*(*C.double)(bind.pbuf) = C.double(aValue)
+	case float64:
+		*(*C.double)(bind.pbuf) = C.double(aValue)
+	case bool: // oracle does not have bool, handle as 0/1 int
+		*(*C.sb8)(bind.pbuf) = 0
+		if aValue {
+			*(*C.sb8)(bind.pbuf) = 1
+		}
+	default:
+		*(*C.sb8)(bind.pbuf) = C.sb8(intToInt64(aValue))
+	}
+
+	if !rebind {
+		return true, nil
+	}
+
+	var err error
+	if len(name) < 1 {
+		err = stmt.ociBindByPos(C.ub4(position+1), bind)
+	} else {
+		err = stmt.ociBindByName([]byte(":"+name), bind)
+	}
+	if err != nil {
+		stmt.freeKeptBind(position)
+		return false, err
+	}
+
+	return true, nil
+}
+
+// bindTemporaryLob makes sbind a temporary LOB of lobType holding value.
+// The temporary LOB is freed with OCILobFreeTemporary by freeBinds.
+func (stmt *Stmt) bindTemporaryLob(sbind *bindStruct, dataType C.ub2, lobType C.ub1, value []byte) error {
+	lobP, _, err := stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_LOB, 0)
+	if err != nil {
+		return err
+	}
+	sbind.dataType = dataType
+	sbind.pbuf = unsafe.Pointer(lobP)
+	sbind.maxSize = C.sb4(sizeOfNilPointer)
+	*sbind.length = C.ub2(sizeOfNilPointer)
+
+	lobLocator := (**C.OCILobLocator)(sbind.pbuf)
+	err = stmt.conn.ociLobCreateTemporary(*lobLocator, C.SQLCS_IMPLICIT, lobType)
+	if err != nil {
+		return err
+	}
+	sbind.lobConn = stmt.conn
+
+	return stmt.conn.ociLobWrite(*lobLocator, C.SQLCS_IMPLICIT, value)
+}
+
+// freeKeptBind frees the buffer kept by the statement for the placeholder at position, if any
+func (stmt *Stmt) freeKeptBind(position int) {
+	if position < len(stmt.binds) {
+		freeBinds(stmt.binds[position : position+1])
+		stmt.binds[position] = bindStruct{}
+	}
+}
+
+// keptBindCapacity returns the buffer size to allocate for a kept bind of dataType holding size bytes.
+// Variable length buffers are rounded up so values that grow a little do not need a new buffer.
+func keptBindCapacity(dataType C.ub2, size int) C.sb4 {
+	switch dataType {
+	case C.SQLT_AFC, C.SQLT_BIN:
+		capacity := 64
+		for capacity < size {
+			capacity *= 2
+		}
+		if capacity > 32767 {
+			capacity = 32767
+		}
+		return C.sb4(capacity)
+	}
+	return C.sb4(size)
+}
+
+// intToInt64 converts any Go integer type to int64. Unsigned values keep their bits.
+func intToInt64(value interface{}) int64 {
+	switch value := value.(type) {
+	case int:
+		return int64(value)
+	case int8:
+		return int64(value)
+	case int16:
+		return int64(value)
+	case int32:
+		return int64(value)
+	case int64:
+		return value
+	case uint:
+		return int64(value)
+	case uint8:
+		return int64(value)
+	case uint16:
+		return int64(value)
+	case uint32:
+		return int64(value)
+	case uint64:
+		return int64(value)
+	case uintptr:
+		return int64(value)
+	}
+	return 0
+}
+
 // Query runs a query
 func (stmt *Stmt) Query(values []driver.Value) (driver.Rows, error) {
 	stmt.ctx = context.Background()
@@ -399,23 +600,16 @@ func (stmt *Stmt) query(binds []bindStruct) (driver.Rows, error) {
 		iter = 0
 	}
 
-	if stmt.conn.prefetchRows != 1 {
-		prefetchRows := stmt.conn.prefetchRows
-		// OCI_ATTR_PREFETCH_ROWS sets the number of top level rows to be prefetched. The default value is 1 row. Value of 0 seems to mean only prefetch memory size limits the number of rows to prefetch.
-		err = stmt.conn.ociAttrSet(unsafe.Pointer(stmt.stmt), C.OCI_HTYPE_STMT, unsafe.Pointer(&prefetchRows), 0, C.OCI_ATTR_PREFETCH_ROWS)
-		if err != nil {
-			return nil, err
+	prefetch := stmt.conn.prefetchFor(stmt.ctx)
+	if prefetch.budget > 0 {
+		// the row width is known before execute when the select-list is in the define cache
+		if defineCache, ok := stmt.conn.defineCache[stmt.cacheKey]; ok {
+			prefetch.rows = prefetchRowsFor(prefetch.budget, defineCache.columns, prefetch.rows)
 		}
 	}
-
-	if stmt.conn.prefetchMemory > 0 {
-		prefetchMemory := stmt.conn.prefetchMemory
-		// OCI_ATTR_PREFETCH_MEMORY sets the memory level for top level rows to be prefetched. Rows up to the specified top level row count are fetched if it occupies no more than the specified memory usage limit.
-		// The default value is 0, which means that memory size is not included in computing the number of rows to prefetch.
-		err = stmt.conn.ociAttrSet(unsafe.Pointer(stmt.stmt), C.OCI_HTYPE_STMT, unsafe.Pointer(&prefetchMemory), 0, C.OCI_ATTR_PREFETCH_MEMORY)
-		if err != nil {
-			return nil, err
-		}
+	err = stmt.setPrefetch(prefetch.rows, prefetch.memory)
+	if err != nil {
+		return nil, err
 	}
 
 	mode := C.ub4(C.OCI_DEFAULT)
@@ -427,16 +621,31 @@ func (stmt *Stmt) query(binds []bindStruct) (driver.Rows, error) {
 		return nil, stmt.ctx.Err()
 	}
 
-	done := make(chan struct{})
-	go stmt.conn.ociBreakDone(stmt.ctx, done)
+	armed := stmt.conn.watchCancel(stmt.ctx)
 	err = stmt.ociStmtExecute(iter, mode)
-	close(done)
+	stmt.conn.unwatchCancel(armed)
 	if err != nil {
+		// the select-list may have changed, so describe it again next time
+		stmt.conn.dropDefines(stmt.cacheKey)
 		return nil, err
 	}
 
+	if stmtType != C.OCI_STMT_SELECT {
+		// a PL/SQL block may return result sets with DBMS_SQL.RETURN_RESULT
+		implicitResultCount := stmt.implicitResultCount()
+		if implicitResultCount > 0 {
+			rows := &Rows{}
+			err = stmt.nextImplicitResult(rows)
+			if err != nil {
+				return nil, err
+			}
+			rows.implicitRemaining = implicitResultCount - 1
+			return rows, nil
+		}
+	}
+
 	var defines []defineStruct
-	defines, err = stmt.makeDefines()
+	defines, err = stmt.makeDefines(stmt.conn.fetchArraySizeFor(stmt.ctx))
 	if err != nil {
 		return nil, err
 	}
@@ -446,15 +655,69 @@ func (stmt *Stmt) query(binds []bindStruct) (driver.Rows, error) {
 		return nil, stmt.ctx.Err()
 	}
 
-	rows := &Rows{
-		stmt:    stmt,
-		defines: defines,
+	rows := newRows(stmt, defines)
+	if prefetch.budget > 0 {
+		rows.prefetchRows = prefetch.rows
+		rows.prefetchMax = prefetchRowsFor(prefetch.budget, defines, 0)
 	}
 
 	return rows, nil
 }
 
-func (stmt *Stmt) makeDefines() ([]defineStruct, error) {
+// setPrefetch sets the prefetch rows and memory of the statement handle if they changed since last set
+func (stmt *Stmt) setPrefetch(rows int, memory int) error {
+	if stmt.prefetchSet && stmt.prefetch.rows == rows && stmt.prefetch.memory == memory {
+		return nil
+	}
+
+	prefetchRows := C.ub4(rows)
+	// OCI_ATTR_PREFETCH_ROWS sets the number of top level rows to be prefetched. The default value is 1 row. Value of 0 seems to mean only prefetch memory size limits the number of rows to prefetch.
+	err := stmt.conn.ociAttrSet(unsafe.Pointer(stmt.stmt), C.OCI_HTYPE_STMT, unsafe.Pointer(&prefetchRows), 0, C.OCI_ATTR_PREFETCH_ROWS)
+	if err != nil {
+		stmt.prefetchSet = false
+		return err
+	}
+
+	prefetchMemory := C.ub4(memory)
+	// OCI_ATTR_PREFETCH_MEMORY sets the memory level for top level rows to be prefetched. Rows up to the specified top level row count are fetched if it occupies no more than the specified memory usage limit.
+	// The default value is 0, which means that memory size is not included in computing the number of rows to prefetch.
+	err = stmt.conn.ociAttrSet(unsafe.Pointer(stmt.stmt), C.OCI_HTYPE_STMT, unsafe.Pointer(&prefetchMemory), 0, C.OCI_ATTR_PREFETCH_MEMORY)
+	if err != nil {
+		stmt.prefetchSet = false
+		return err
+	}
+
+	stmt.prefetch = prefetchStruct{rows: rows, memory: memory}
+	stmt.prefetchSet = true
+	return nil
+}
+
+// prefetchRowsFor returns the number of rows of the described columns that fit in budget bytes, at least 1.
+// When max is not 0 the result is at most max.
+func prefetchRowsFor(budget int, columns []defineStruct, max int) int {
+	// buffer, length, and indicator of each column
+	width := 0
+	for i := 0; i < len(columns); i++ {
+		width += int(columns[i].maxSize) + 4
+	}
+	if width < 1 {
+		width = 1
+	}
+
+	rows := budget / width
+	if max > 0 && rows > max {
+		rows = max
+	}
+	if rows < 1 {
+		rows = 1
+	}
+	return rows
+}
+
+// makeDefines describes the select-list then allocates and defines buffers holding fetchArraySize rows for each column.
+// For statements from the statement cache, the described columns and the buffers of the last closed rows are
+// kept by the connection under the cache key, so running the same statement again with the same columns skips the mallocs.
+func (stmt *Stmt) makeDefines(fetchArraySize int) ([]defineStruct, error) {
 	var paramCountUb4 C.ub4 // number of columns in the select-list
 	_, err := stmt.ociAttrGet(unsafe.Pointer(&paramCountUb4), C.OCI_ATTR_PARAM_COUNT)
 	if err != nil {
@@ -462,7 +725,60 @@ func (stmt *Stmt) makeDefines() ([]defineStruct, error) {
 	}
 	paramCount := int(paramCountUb4)
 
-	defines := make([]defineStruct, paramCount)
+	if fetchArraySize < 1 {
+		fetchArraySize = 1
+	}
+
+	// describing is done in the client from the describe data of the execute, so it is cheap enough
+	// to always do it and catch columns changed by DDL since the buffers were kept
+	columns, err := stmt.describeColumns(paramCount)
+	if err != nil {
+		return nil, err
+	}
+
+	var defines []defineStruct
+	if stmt.cacheKey != "" {
+		defines = stmt.conn.getDefines(stmt.cacheKey, columns, fetchArraySize)
+	}
+
+	// ref cursor handles are reused row by row, so do not array fetch when there is a ref cursor column
+	for i := 0; i < len(columns) && fetchArraySize > 1; i++ {
+		if columns[i].dataType == C.SQLT_RSET {
+			fetchArraySize = 1
+		}
+	}
+
+	lobInlineSize := stmt.conn.lobInlineSizeFor(stmt.ctx)
+	if defines != nil && lobInlineSize > 0 && hasLobColumn(columns) {
+		// kept buffers are locators, give them back and allocate inline buffers
+		if !stmt.conn.putDefines(stmt.cacheKey, defines) {
+			freeDefines(defines)
+		}
+		defines = nil
+	}
+
+	if defines == nil {
+		defines = make([]defineStruct, paramCount)
+		copy(defines, columns)
+		for i := 0; i < paramCount; i++ {
+			if lobInlineSize > 0 {
+				// LOB data is converted to a long string or raw when fetched
+				switch defines[i].dataType {
+				case C.SQLT_CLOB:
+					defines[i].dataType = C.SQLT_LNG
+					defines[i].maxSize = C.sb4(lobInlineSize)
+				case C.SQLT_BLOB:
+					defines[i].dataType = C.SQLT_BIN
+					defines[i].maxSize = C.sb4(lobInlineSize)
+				}
+			}
+			err = stmt.conn.allocDefine(&defines[i], fetchArraySize)
+			if err != nil {
+				freeDefines(defines)
+				return nil, err
+			}
+		}
+	}
 
 	for i := 0; i < paramCount; i++ {
 		if stmt.ctx.Err() != nil {
@@ -470,218 +786,223 @@ func (stmt *Stmt) makeDefines() ([]defineStruct, error) {
 			return nil, stmt.ctx.Err()
 		}
 
-		var param *C.OCIParam
-		param, err = stmt.ociParamGet(C.ub4(i + 1))
-		if err != nil {
+		result := C.OCIDefineByPos(
+			stmt.stmt,                            // statement handle
+			&defines[i].defineHandle,             // pointer to a pointer to a define handle. If NULL, this call implicitly allocates the define handle.
+			stmt.conn.errHandle,                  // error handle
+			C.ub4(i+1),                           // position of this value in the select list. Positions are 1-based and are numbered from left to right.
+			defines[i].pbuf,                      // pointer to a buffer
+			defines[i].maxSize,                   // size of each valuep buffer in bytes, also the skip between rows of an array fetch
+			defines[i].dataType,                  // datatype
+			unsafe.Pointer(defines[i].indicator), // pointer to an indicator variable or array
+			defines[i].length,                    // pointer to array of length of data fetched
+			nil,                                  // pointer to array of column-level return codes
+			C.OCI_DEFAULT,                        // mode - OCI_DEFAULT - This is the default mode.
+		)
+		if result != C.OCI_SUCCESS {
 			freeDefines(defines)
-			return nil, err
+			return nil, stmt.conn.getError(result)
 		}
-		defer C.OCIDescriptorFree(unsafe.Pointer(param), C.OCI_DTYPE_PARAM)
+	}
 
-		var dataType C.ub2 // external datatype of the column: https://docs.oracle.com/cd/E11882_01/appdev.112/e10646/oci03typ.htm#CEGIEEJI
-		_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&dataType), C.OCI_ATTR_DATA_TYPE)
+	lobPrefetchSize := C.ub4(stmt.conn.lobPrefetchSizeFor(stmt.ctx))
+	for i := 0; i < paramCount && lobPrefetchSize > 0; i++ {
+		if defines[i].dataType != C.SQLT_CLOB && defines[i].dataType != C.SQLT_BLOB {
+			continue
+		}
+		// OCI_ATTR_LOBPREFETCH_SIZE sets the number of bytes of LOB data prefetched with each locator
+		err = stmt.conn.ociAttrSet(unsafe.Pointer(defines[i].defineHandle), C.OCI_HTYPE_DEFINE, unsafe.Pointer(&lobPrefetchSize), 0, C.OCI_ATTR_LOBPREFETCH_SIZE)
 		if err != nil {
 			freeDefines(defines)
 			return nil, err
 		}
-
-		var columnName *C.OraText // name of the column
-		var size C.ub4
-		size, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&columnName), C.OCI_ATTR_NAME)
+		// OCI_ATTR_LOBPREFETCH_LENGTH prefetches the LOB length and chunk size with the locator
+		prefetchLength := C.boolean(C.TRUE)
+		err = stmt.conn.ociAttrSet(unsafe.Pointer(defines[i].defineHandle), C.OCI_HTYPE_DEFINE, unsafe.Pointer(&prefetchLength), 0, C.OCI_ATTR_LOBPREFETCH_LENGTH)
 		if err != nil {
 			freeDefines(defines)
 			return nil, err
 		}
-		defines[i].name = cGoStringN(columnName, int(size))
+	}
 
-		var maxSize C.ub4 // Maximum size in bytes of the external data for the column. This can affect conversion buffer sizes.
-		_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&maxSize), C.OCI_ATTR_DATA_SIZE)
+	return defines, nil
+}
+
+// hasLobColumn returns true if any of the columns is a CLOB or BLOB
+func hasLobColumn(columns []defineStruct) bool {
+	for i := 0; i < len(columns); i++ {
+		if columns[i].dataType == C.SQLT_CLOB || columns[i].dataType == C.SQLT_BLOB {
+			return true
+		}
+	}
+	return false
+}
+
+// describeColumns describes the select-list and returns defines with the name, define data type, and buffer size
+// of each column set. Buffers are not allocated.
+func (stmt *Stmt) describeColumns(paramCount int) ([]defineStruct, error) {
+	columns := make([]defineStruct, paramCount)
+
+	for i := 0; i < paramCount; i++ {
+		if stmt.ctx.Err() != nil {
+			return nil, stmt.ctx.Err()
+		}
+
+		param, err := stmt.ociParamGet(C.ub4(i + 1))
 		if err != nil {
-			freeDefines(defines)
 			return nil, err
 		}
-
-		// In OBCI v2.1.0 and earlier, when the server returns a maxsize of 65536, it overflows to 0
-		if maxSize == 0 {
-			maxSize = 65535
+		err = stmt.describeColumn(param, &columns[i])
+		C.OCIDescriptorFree(unsafe.Pointer(param), C.OCI_DTYPE_PARAM)
+		if err != nil {
+			return nil, err
 		}
+	}
 
-		defines[i].length = (*C.ub2)(C.malloc(C.sizeof_ub2))
-		*defines[i].length = 0
-		defines[i].indicator = (*C.sb2)(C.malloc(C.sizeof_sb2))
-		*defines[i].indicator = 0
-
-		// switch on dataType
-		switch dataType {
-
-		case C.SQLT_AFC, C.SQLT_CHR, C.SQLT_VCS, C.SQLT_AVC:
-			defines[i].dataType = C.SQLT_AFC
-			// For a database with character set to ZHS16GBK the OCI C driver does not seem to report the correct max size, not sure exactly why.
-			// Doubling the max size of the buffer seems to fix the issue, not sure if there is a better fix.
-			defines[i].maxSize = C.sb4(maxSize * 2)
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-
-		case C.SQLT_BIN:
-			defines[i].dataType = C.SQLT_BIN
-			defines[i].maxSize = C.sb4(maxSize)
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-
-		case C.SQLT_NUM:
-			var precision C.sb2 // the precision
-			_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&precision), C.OCI_ATTR_PRECISION)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
+	return columns, nil
+}
 
-			var scale C.sb1 // the scale (number of digits to the right of the decimal point)
-			_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&scale), C.OCI_ATTR_SCALE)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
+// describeColumn sets the name, define data type, and buffer size of column from the parameter descriptor param
+func (stmt *Stmt) describeColumn(param *C.OCIParam, column *defineStruct) error {
+	var dataType C.ub2 // external datatype of the column: https://docs.oracle.com/cd/E11882_01/appdev.112/e10646/oci03typ.htm#CEGIEEJI
+	_, err := stmt.conn.ociAttrGet(param, unsafe.Pointer(&dataType), C.OCI_ATTR_DATA_TYPE)
+	if err != nil {
+		return err
+	}
 
-			// The precision of numeric type attributes. If the precision is nonzero and scale is -127, then it is a FLOAT;
-			// otherwise, it is a NUMBER(precision, scale).
-			// When precision is 0, NUMBER(precision, scale) can be represented simply as NUMBER.
-			// https://docs.oracle.com/cd/E11882_01/appdev.112/e10646/oci06des.htm#LNOCI16458
+	var columnName *C.OraText // name of the column
+	var size C.ub4
+	size, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&columnName), C.OCI_ATTR_NAME)
+	if err != nil {
+		return err
+	}
+	column.name = cGoStringN(columnName, int(size))
 
-			// note that select sum and count both return as precision == 0 && scale == 0 so use float64 (SQLT_BDOUBLE) to handle both
+	var maxSize C.ub4 // Maximum size in bytes of the external data for the column. This can affect conversion buffer sizes.
+	_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&maxSize), C.OCI_ATTR_DATA_SIZE)
+	if err != nil {
+		return err
+	}
 
-			if (precision == 0 && scale == 0) || scale > 0 || scale == -127 {
-				defines[i].dataType = C.SQLT_BDOUBLE
-				defines[i].maxSize = 8
-				defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-			} else {
-				defines[i].dataType = C.SQLT_INT
-				defines[i].maxSize = 8
-				defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-			}
+	// In OBCI v2.1.0 and earlier, when the server returns a maxsize of 65536, it overflows to 0
+	if maxSize == 0 {
+		maxSize = 65535
+	}
 
-		case C.SQLT_INT:
-			defines[i].dataType = C.SQLT_INT
-			defines[i].maxSize = 8
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-
-		case C.SQLT_BDOUBLE, C.SQLT_IBDOUBLE, C.SQLT_BFLOAT, C.SQLT_IBFLOAT:
-			defines[i].dataType = C.SQLT_BDOUBLE
-			defines[i].maxSize = 8
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-
-		case C.SQLT_LNG:
-			defines[i].dataType = C.SQLT_LNG
-			defines[i].maxSize = 4000
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-
-		case C.SQLT_CLOB, C.SQLT_BLOB:
-			defines[i].dataType = dataType
-			defines[i].maxSize = C.sb4(sizeOfNilPointer)
-			var lobP *unsafe.Pointer
-			lobP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_LOB, 0)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
-			defines[i].pbuf = unsafe.Pointer(lobP)
+	// switch on dataType
+	switch dataType {
 
-		case C.SQLT_TIMESTAMP, C.SQLT_DAT:
-			defines[i].dataType = C.SQLT_TIMESTAMP
-			defines[i].maxSize = C.sb4(sizeOfNilPointer)
-			var timestampP *unsafe.Pointer
-			timestampP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_TIMESTAMP, 0)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
-			defines[i].pbuf = unsafe.Pointer(timestampP)
+	case C.SQLT_AFC, C.SQLT_CHR, C.SQLT_VCS, C.SQLT_AVC:
+		column.dataType = C.SQLT_AFC
+		// For a database with character set to ZHS16GBK the OCI C driver does not seem to report the correct max size, not sure exactly why.
+		// Doubling the max size of the buffer seems to fix the issue, not sure if there is a better fix.
+		column.maxSize = C.sb4(maxSize * 2)
 
-		case C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ:
-			defines[i].dataType = C.SQLT_TIMESTAMP_TZ
-			defines[i].maxSize = C.sb4(sizeOfNilPointer)
-			var timestampP *unsafe.Pointer
-			timestampP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_TIMESTAMP_TZ, 0)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
-			defines[i].pbuf = unsafe.Pointer(timestampP)
-
-		case C.SQLT_INTERVAL_DS:
-			defines[i].dataType = C.SQLT_INTERVAL_DS
-			defines[i].maxSize = C.sb4(sizeOfNilPointer)
-			var intervalP *unsafe.Pointer
-			intervalP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_INTERVAL_DS, 0)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
-			defines[i].pbuf = unsafe.Pointer(intervalP)
+	case C.SQLT_BIN:
+		column.dataType = C.SQLT_BIN
+		column.maxSize = C.sb4(maxSize)
 
-		case C.SQLT_INTERVAL_YM:
-			defines[i].dataType = C.SQLT_INTERVAL_YM
-			defines[i].maxSize = C.sb4(sizeOfNilPointer)
-			var intervalP *unsafe.Pointer
-			intervalP, _, err = stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_INTERVAL_YM, 0)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
-			defines[i].pbuf = unsafe.Pointer(intervalP)
-
-		case C.SQLT_RDD: // rowid
-			defines[i].dataType = C.SQLT_AFC
-			defines[i].maxSize = 40
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
-
-		case C.SQLT_RSET: // ref cursor
-			defines[i].dataType = dataType
-			defines[i].maxSize = C.sb4(sizeOfNilPointer)
-			var stmtP *unsafe.Pointer
-			stmtP, _, err = stmt.conn.ociHandleAlloc(C.OCI_HTYPE_STMT, 0)
-			if err != nil {
-				freeDefines(defines)
-				return nil, err
-			}
-			defines[i].pbuf = unsafe.Pointer(stmtP)
+	case C.SQLT_NUM:
+		var precision C.sb2 // the precision
+		_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&precision), C.OCI_ATTR_PRECISION)
+		if err != nil {
+			return err
+		}
 
-		default:
-			defines[i].dataType = C.SQLT_AFC
-			defines[i].maxSize = C.sb4(maxSize)
-			defines[i].pbuf = C.malloc(C.size_t(defines[i].maxSize))
+		var scale C.sb1 // the scale (number of digits to the right of the decimal point)
+		_, err = stmt.conn.ociAttrGet(param, unsafe.Pointer(&scale), C.OCI_ATTR_SCALE)
+		if err != nil {
+			return err
 		}
 
-		result := C.OCIDefineByPos(
-			stmt.stmt,                            // statement handle
-			&defines[i].defineHandle,             // pointer to a pointer to a define handle. If NULL, this call implicitly allocates the define handle.
-			stmt.conn.errHandle,                  // error handle
-			C.ub4(i+1),                           // position of this value in the select list. Positions are 1-based and are numbered from left to right.
-			defines[i].pbuf,                      // pointer to a buffer
-			defines[i].maxSize,                   // size of each valuep buffer in bytes
-			defines[i].dataType,                  // datatype
-			unsafe.Pointer(defines[i].indicator), // pointer to an indicator variable or array
-			defines[i].length,                    // pointer to array of length of data fetched
-			nil,                                  // pointer to array of column-level return codes
-			C.OCI_DEFAULT,                        // mode - OCI_DEFAULT - This is the default mode.
-		)
-		if result != C.OCI_SUCCESS {
-			freeDefines(defines)
-			return nil, stmt.conn.getError(result)
+		// The precision of numeric type attributes. If the precision is nonzero and scale is -127, then it is a FLOAT;
+		// otherwise, it is a NUMBER(precision, scale).
+		// When precision is 0, NUMBER(precision, scale) can be represented simply as NUMBER.
+		// https://docs.oracle.com/cd/E11882_01/appdev.112/e10646/oci06des.htm#LNOCI16458
+
+		// note that select sum and count both return as precision == 0 && scale == 0 so use float64 (SQLT_BDOUBLE) to handle both
+
+		// with exact numbers, columns that could lose digits as float64 or int64 are defined as VARNUM
+		// and decoded by decodeNumber: a length byte followed by up to 21 bytes of the internal NUMBER format
+
+		if stmt.conn.exactNumbers && ((precision == 0 && scale == 0) || scale > 0 || scale == -127 || precision > 18) {
+			column.dataType = C.SQLT_VNU
+			column.maxSize = 22
+		} else if (precision == 0 && scale == 0) || scale > 0 || scale == -127 {
+			column.dataType = C.SQLT_BDOUBLE
+			column.maxSize = 8
+		} else {
+			column.dataType = C.SQLT_INT
+			column.maxSize = 8
 		}
+
+	case C.SQLT_INT:
+		column.dataType = C.SQLT_INT
+		column.maxSize = 8
+
+	case C.SQLT_BDOUBLE, C.SQLT_IBDOUBLE, C.SQLT_BFLOAT, C.SQLT_IBFLOAT:
+		column.dataType = C.SQLT_BDOUBLE
+		column.maxSize = 8
+
+	case C.SQLT_LNG:
+		column.dataType = C.SQLT_LNG
+		column.maxSize = 4000
+
+	case C.SQLT_CLOB, C.SQLT_BLOB:
+		column.dataType = dataType
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	case C.SQLT_DAT:
+		// the 7 byte internal format, decoded in Go without a descriptor
+		column.dataType = C.SQLT_DAT
+		column.maxSize = 7
+
+	case C.SQLT_TIMESTAMP:
+		column.dataType = C.SQLT_TIMESTAMP
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	case C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ:
+		column.dataType = C.SQLT_TIMESTAMP_TZ
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	case C.SQLT_INTERVAL_DS:
+		column.dataType = C.SQLT_INTERVAL_DS
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	case C.SQLT_INTERVAL_YM:
+		column.dataType = C.SQLT_INTERVAL_YM
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	case C.SQLT_RDD: // rowid
+		column.dataType = C.SQLT_AFC
+		column.maxSize = 40
+
+	case C.SQLT_RSET: // ref cursor
+		column.dataType = dataType
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	case C.SQLT_JSON: // native JSON, fetched in the binary format
+		column.dataType = dataType
+		column.maxSize = C.sb4(sizeOfNilPointer)
+
+	default:
+		column.dataType = C.SQLT_AFC
+		column.maxSize = C.sb4(maxSize)
 	}
 
-	return defines, nil
+	return nil
 }
 
 // getRowid returns the rowid
 func (stmt *Stmt) getRowid() (string, error) {
-	rowidP, _, err := stmt.conn.ociDescriptorAlloc(C.OCI_DTYPE_ROWID, 0)
+	rowidP, err := stmt.conn.environment.descriptorGet(C.OCI_DTYPE_ROWID)
 	if err != nil {
 		return "", err
 	}
-	defer C.OCIDescriptorFree(*rowidP, C.OCI_DTYPE_ROWID)
+	defer stmt.conn.environment.descriptorPut(C.OCI_DTYPE_ROWID, rowidP)
 
 	// OCI_ATTR_ROWID returns the ROWID descriptor allocated with OCIDescriptorAlloc()
-	_, err = stmt.ociAttrGet(*rowidP, C.OCI_ATTR_ROWID)
+	_, err = stmt.ociAttrGet(rowidP, C.OCI_ATTR_ROWID)
 	if err != nil {
 		return "", err
 	}
@@ -689,7 +1010,7 @@ func (stmt *Stmt) getRowid() (string, error) {
 	rowid := cStringN("", 18)
 	defer C.free(unsafe.Pointer(rowid))
 	rowidLength := C.ub2(18)
-	result := C.OCIRowidToChar((*C.OCIRowid)(*rowidP), rowid, &rowidLength, stmt.conn.errHandle)
+	result := C.OCIRowidToChar((*C.OCIRowid)(rowidP), rowid, &rowidLength, stmt.conn.errHandle)
 	err = stmt.conn.getError(result)
 	if err != nil {
 		return "", err
@@ -742,10 +1063,9 @@ func (stmt *Stmt) exec(binds []bindStruct) (driver.Result, error) {
 		return nil, stmt.ctx.Err()
 	}
 
-	done := make(chan struct{})
-	go stmt.conn.ociBreakDone(stmt.ctx, done)
+	armed := stmt.conn.watchCancel(stmt.ctx)
 	err := stmt.ociStmtExecute(1, mode)
-	close(done)
+	stmt.conn.unwatchCancel(armed)
 	if err != nil && err != ErrOCISuccessWithInfo {
 		return nil, err
 	}
@@ -775,6 +1095,21 @@ func (stmt *Stmt) outputBoundParameters(binds []bindStruct) error {
 		if bind.pbuf != nil {
 			switch dest := bind.out.Dest.(type) {
 
+			case *driver.Rows:
+				if *bind.indicator == -1 { // the cursor is null
+					*dest = nil
+					break
+				}
+				handle := (*unsafe.Pointer)(bind.pbuf)
+				cursorRows, err := stmt.conn.cursorRows((*C.OCIStmt)(*handle), stmt.ctx)
+				if err != nil {
+					return fmt.Errorf("ref cursor for column %v - error: %v", i, err)
+				}
+				// the rows free the handle when closed, not freeBinds
+				cursorRows.ownsStmt = true
+				*handle = nil
+				*dest = cursorRows
+
 			case *string:
 				switch {
 				case *bind.indicator > 0: // indicator variable is the actual length before truncation
@@ -1019,18 +1354,33 @@ func (stmt *Stmt) ociBindByPos(position C.ub4, bind *bindStruct) error {
 	return stmt.conn.getError(result)
 }
 
-// ociStmtExecute calls OCIStmtExecute
+// ociStmtExecute calls OCIStmtExecute.
+// While OCIStmtExecute returns OCI_NEED_DATA, the next piece of a StreamValue bind is sent and OCIStmtExecute is called again.
 func (stmt *Stmt) ociStmtExecute(iters C.ub4, mode C.ub4) error {
-	result := C.OCIStmtExecute(
-		stmt.conn.svc,       // Service context handle
-		stmt.stmt,           // A statement handle
-		stmt.conn.errHandle, // An error handle
-		iters,               // For non-SELECT statements, the number of times this statement is executed equals iters - rowoff. For SELECT statements, if iters is nonzero, then defines must have been done for the statement handle.
-		0,                   // The starting index from which the data in an array bind is relevant for this multiple row execution
-		nil,                 // This parameter is optional. If it is supplied, it must point to a snapshot descriptor of type OCI_DTYPE_SNAP
-		nil,                 // This parameter is optional. If it is supplied, it must point to a descriptor of type OCI_DTYPE_SNAP.
-		mode,                // The mode: https://docs.oracle.com/cd/E11882_01/appdev.112/e10646/oci17msc001.htm#LNOCI17163
-	)
+	var result C.sword
+	for {
+		result = C.OCIStmtExecute(
+			stmt.conn.svc,       // Service context handle
+			stmt.stmt,           // A statement handle
+			stmt.conn.errHandle, // An error handle
+			iters,               // For non-SELECT statements, the number of times this statement is executed equals iters - rowoff. For SELECT statements, if iters is nonzero, then defines must have been done for the statement handle.
+			0,                   // The starting index from which the data in an array bind is relevant for this multiple row execution
+			nil,                 // This parameter is optional. If it is supplied, it must point to a snapshot descriptor of type OCI_DTYPE_SNAP
+			nil,                 // This parameter is optional. If it is supplied, it must point to a descriptor of type OCI_DTYPE_SNAP.
+			mode,                // The mode: https://docs.oracle.com/cd/E11882_01/appdev.112/e10646/oci17msc001.htm#LNOCI17163
+		)
+		if result != C.OCI_NEED_DATA || len(stmt.streams) == 0 {
+			break
+		}
+
+		err := stmt.ociSetPiece()
+		if err != nil {
+			if stmt.cacheKey != "" {
+				stmt.releaseMode = C.OCI_STRLS_CACHE_DELETE
+			}
+			return err
+		}
+	}
 
 	if stmt.cacheKey != "" && result != C.OCI_SUCCESS && result != C.OCI_SUCCESS_WITH_INFO {
 		// drop statement from cache for all errors when caching is enabled
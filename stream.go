@@ -0,0 +1,165 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"errors"
+	"fmt"
+	"io"
+	"math"
+	"unsafe"
+)
+
+// newStreamBind returns the state of a StreamValue bind with its C piece buffer allocated
+func newStreamBind(value StreamValue) *streamBindStruct {
+	if value.PieceSize < 1 {
+		value.PieceSize = streamPieceSize
+	}
+	return &streamBindStruct{
+		value:  value,
+		buffer: C.malloc(C.size_t(value.PieceSize)),
+		length: (*C.ub4)(C.malloc(C.sizeof_ub4)),
+	}
+}
+
+// free frees the C piece buffer
+func (stream *streamBindStruct) free() {
+	if stream.buffer != nil {
+		C.free(stream.buffer)
+		stream.buffer = nil
+	}
+	if stream.length != nil {
+		C.free(unsafe.Pointer(stream.length))
+		stream.length = nil
+	}
+}
+
+// ociBindStream binds a StreamValue by position, or by name if name is set, with OCI_DATA_AT_EXEC.
+// The data is given later piece by piece by ociSetPiece.
+func (stmt *Stmt) ociBindStream(position C.ub4, name string, bind *bindStruct) error {
+	bind.dataType = C.SQLT_LBI
+	if bind.stream.value.Text {
+		bind.dataType = C.SQLT_LNG
+	}
+
+	// the maximum size of the whole value
+	maxSize := C.sb8(math.MaxInt32)
+	if bind.stream.value.Size > 0 {
+		maxSize = C.sb8(bind.stream.value.Size)
+	}
+
+	var result C.sword
+	if len(name) < 1 {
+		result = C.OCIBindByPos2(
+			stmt.stmt,                      // The statement handle
+			&bind.stream.bindHandle,        // The bind handle that is implicitly allocated by this call. The handle is freed implicitly when the statement handle is deallocated.
+			stmt.conn.errHandle,            // An error handle
+			position,                       // The placeholder attributes are specified by position if OCIBindByPos() is being called.
+			nil,                            // no data value, the data is given at execute time with OCIStmtSetPieceInfo
+			maxSize,                        // The maximum size possible in bytes of the data value for this bind variable
+			bind.dataType,                  // The data type of the value being bound
+			unsafe.Pointer(bind.indicator), // Pointer to an indicator variable
+			nil,                            // lengths are given with each piece
+			nil,                            // Pointer to the array of column-level return codes
+			0,                              // A maximum array length parameter
+			nil,                            // Current array length parameter
+			C.OCI_DATA_AT_EXEC,             // The mode. OCI_DATA_AT_EXEC: the data is provided at run time piece by piece
+		)
+	} else {
+		placeholder := cString(":" + name)
+		defer C.free(unsafe.Pointer(placeholder))
+		result = C.OCIBindByName2(
+			stmt.stmt,                      // The statement handle
+			&bind.stream.bindHandle,        // The bind handle that is implicitly allocated by this call. The handle is freed implicitly when the statement handle is deallocated.
+			stmt.conn.errHandle,            // An error handle
+			placeholder,                    // The placeholder, specified by its name, that maps to a variable in the statement associated with the statement handle.
+			C.sb4(len(name)+1),             // The length of the name specified in placeholder, in number of bytes regardless of the encoding.
+			nil,                            // no data value, the data is given at execute time with OCIStmtSetPieceInfo
+			maxSize,                        // The maximum size possible in bytes of the data value for this bind variable
+			bind.dataType,                  // The data type of the value being bound
+			unsafe.Pointer(bind.indicator), // Pointer to an indicator variable
+			nil,                            // lengths are given with each piece
+			nil,                            // Pointer to the array of column-level return codes
+			0,                              // A maximum array length parameter
+			nil,                            // Current array length parameter
+			C.OCI_DATA_AT_EXEC,             // The mode. OCI_DATA_AT_EXEC: the data is provided at run time piece by piece
+		)
+	}
+	bind.bindHandle = bind.stream.bindHandle
+
+	return stmt.conn.getError(result)
+}
+
+// ociSetPiece is called when OCIStmtExecute returns OCI_NEED_DATA.
+// It reads the next piece of the StreamValue bind OCI asks for and gives it to OCI with OCIStmtSetPieceInfo.
+// On a read error, or when the Reader ends before Size bytes, the execute is interrupted with OCIBreak
+// so no truncated value is written.
+func (stmt *Stmt) ociSetPiece() error {
+	var handle unsafe.Pointer
+	var handleType C.ub4
+	var inOut C.ub1
+	var iteration C.ub4
+	var index C.ub4
+	var piece C.ub1
+	result := C.OCIStmtGetPieceInfo(
+		stmt.stmt,           // statement handle
+		stmt.conn.errHandle, // error handle
+		&handle,             // returns the bind handle the piece is for
+		&handleType,         // returns the handle type, OCI_HTYPE_BIND
+		&inOut,              // returns OCI_PARAM_IN for a bind
+		&iteration,          // returns the row number of a multiple row execute
+		&index,              // returns the index of an array bind
+		&piece,              // returns OCI_FIRST_PIECE or OCI_NEXT_PIECE
+	)
+	if result != C.OCI_SUCCESS {
+		return stmt.conn.getError(result)
+	}
+
+	var stream *streamBindStruct
+	for _, aStream := range stmt.streams {
+		if unsafe.Pointer(aStream.bindHandle) == handle {
+			stream = aStream
+			break
+		}
+	}
+	if stream == nil || stream.done || handleType != C.OCI_HTYPE_BIND {
+		stmt.conn.ociBreak()
+		return errors.New("OCI asked for a piece of an unknown bind")
+	}
+
+	// the Reader reads directly into the C buffer
+	buffer := (*[1 << 30]byte)(stream.buffer)[:stream.value.PieceSize:stream.value.PieceSize]
+	if stream.value.Size > 0 && stream.value.Size-stream.sent < int64(len(buffer)) {
+		buffer = buffer[:stream.value.Size-stream.sent]
+	}
+	length, err := io.ReadFull(stream.value.Reader, buffer)
+	stream.sent += int64(length)
+	if stream.value.Size > 0 && stream.sent < stream.value.Size && (err == io.EOF || err == io.ErrUnexpectedEOF) {
+		stmt.conn.ociBreak()
+		return fmt.Errorf("stream value reader ended after %v of its %v bytes", stream.sent, stream.value.Size)
+	}
+	if err == io.EOF || err == io.ErrUnexpectedEOF || (stream.value.Size > 0 && stream.sent >= stream.value.Size) {
+		stream.done = true
+		piece = C.OCI_LAST_PIECE
+	} else if err != nil {
+		stmt.conn.ociBreak()
+		return err
+	} else if piece != C.OCI_FIRST_PIECE {
+		piece = C.OCI_NEXT_PIECE
+	}
+
+	*stream.length = C.ub4(length)
+	result = C.OCIStmtSetPieceInfo(
+		handle,              // bind handle
+		C.OCI_HTYPE_BIND,    // handle type
+		stmt.conn.errHandle, // error handle
+		stream.buffer,       // buffer of the piece
+		stream.length,       // length of the piece, read by OCI during the next OCIStmtExecute
+		piece,               // OCI_FIRST_PIECE, OCI_NEXT_PIECE, or OCI_LAST_PIECE
+		nil,                 // indicator
+		nil,                 // return code
+	)
+
+	return stmt.conn.getError(result)
+}
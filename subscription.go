@@ -0,0 +1,427 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"context"
+	"database/sql/driver"
+	"errors"
+	"fmt"
+	"sync/atomic"
+	"unsafe"
+)
+
+// Event types of a SubscriptionEvent
+const (
+	EventNone         = C.OCI_EVENT_NONE
+	EventStartup      = C.OCI_EVENT_STARTUP
+	EventShutdown     = C.OCI_EVENT_SHUTDOWN
+	EventShutdownAny  = C.OCI_EVENT_SHUTDOWN_ANY
+	EventDropDatabase = C.OCI_EVENT_DROP_DB
+	EventDeregister   = C.OCI_EVENT_DEREG // the registration was removed, by timeout or by the database, no more events follow
+	EventObjectChange = C.OCI_EVENT_OBJCHANGE
+	EventQueryChange  = C.OCI_EVENT_QUERYCHANGE
+)
+
+// Operation flags of table, row, and query changes
+const (
+	OperationAllRows = C.OCI_OPCODE_ALLROWS // all rows of the table are invalidated, rowids are not given
+	OperationInsert  = C.OCI_OPCODE_INSERT
+	OperationUpdate  = C.OCI_OPCODE_UPDATE
+	OperationDelete  = C.OCI_OPCODE_DELETE
+	OperationAlter   = C.OCI_OPCODE_ALTER
+	OperationDrop    = C.OCI_OPCODE_DROP
+	OperationUnknown = C.OCI_OPCODE_UNKNOWN
+)
+
+const (
+	defaultSubscriptionBufferSize = 64
+)
+
+// NewSubscription registers a continuous query notification subscription.
+// Register queries with it, then read the change events from Events until it is closed.
+// The connection must be opened with the events DSN parameter.
+// To get the driver Conn from a sql.Conn use sql.Conn.Raw
+func (conn *Conn) NewSubscription(ctx context.Context, options *SubscriptionOptions) (*Subscription, error) {
+	if conn.environment.mode&C.OCI_EVENTS == 0 {
+		return nil, errors.New("subscription needs a connection opened with events=true")
+	}
+	if options == nil {
+		options = &SubscriptionOptions{}
+	}
+	bufferSize := options.BufferSize
+	if bufferSize < 1 {
+		bufferSize = defaultSubscriptionBufferSize
+	}
+
+	handle, _, err := conn.ociHandleAlloc(C.OCI_HTYPE_SUBSCRIPTION, 0)
+	if err != nil {
+		return nil, fmt.Errorf("allocate subscription handle error: %v", err)
+	}
+	errHandle, _, err := conn.ociHandleAlloc(C.OCI_HTYPE_ERROR, 0)
+	if err != nil {
+		C.OCIHandleFree(*handle, C.OCI_HTYPE_SUBSCRIPTION)
+		return nil, fmt.Errorf("allocate subscription error handle error: %v", err)
+	}
+
+	subscription := newSubscription(bufferSize)
+	subscription.conn = conn
+	subscription.handle = (*C.OCISubscription)(*handle)
+	subscription.errHandle = (*C.OCIError)(*errHandle)
+
+	err = subscription.setAttributes(options)
+	if err != nil {
+		subscription.stop()
+		subscription.free()
+		return nil, err
+	}
+
+	armed := conn.watchCancel(ctx)
+	result := C.OCISubscriptionRegister(
+		conn.svc,             // service context
+		&subscription.handle, // subscription handles to register
+		1,                    // number of subscription handles
+		conn.errHandle,       // error handle
+		C.OCI_DEFAULT,        // mode
+	)
+	conn.unwatchCancel(armed)
+	err = conn.getError(result)
+	if err != nil {
+		subscription.stop()
+		subscription.free()
+		return nil, fmt.Errorf("subscription register error: %v", err)
+	}
+
+	return subscription, nil
+}
+
+// setAttributes sets the namespace, callback, and options of the subscription handle
+func (subscription *Subscription) setAttributes(options *SubscriptionOptions) error {
+	conn := subscription.conn
+	handle := unsafe.Pointer(subscription.handle)
+
+	namespace := C.ub4(C.OCI_SUBSCR_NAMESPACE_DBCHANGE)
+	err := conn.ociAttrSet(handle, C.OCI_HTYPE_SUBSCRIPTION, unsafe.Pointer(&namespace), 0, C.OCI_ATTR_SUBSCR_NAMESPACE)
+	if err != nil {
+		return fmt.Errorf("subscription namespace error: %v", err)
+	}
+
+	result := C.ociSubscriptionSetCallback(
+		subscription.handle,          // subscription handle
+		conn.errHandle,               // error handle
+		C.uintptr_t(subscription.id), // subscription id, the context of the callback
+	)
+	err = conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("subscription callback error: %v", err)
+	}
+
+	if options.Rowids {
+		rowids := C.boolean(1)
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_SUBSCRIPTION, unsafe.Pointer(&rowids), 0, C.OCI_ATTR_CHNF_ROWIDS)
+		if err != nil {
+			return fmt.Errorf("subscription rowids error: %v", err)
+		}
+	}
+
+	if options.QueryLevel {
+		qosFlags := C.ub4(C.OCI_SUBSCR_CQ_QOS_QUERY)
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_SUBSCRIPTION, unsafe.Pointer(&qosFlags), 0, C.OCI_ATTR_SUBSCR_CQ_QOSFLAGS)
+		if err != nil {
+			return fmt.Errorf("subscription query level error: %v", err)
+		}
+		subscription.queryLevel = true
+	}
+
+	if options.Timeout > 0 {
+		timeout := C.ub4(options.Timeout.Seconds())
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_SUBSCRIPTION, unsafe.Pointer(&timeout), 0, C.OCI_ATTR_SUBSCR_TIMEOUT)
+		if err != nil {
+			return fmt.Errorf("subscription timeout error: %v", err)
+		}
+	}
+
+	if options.Port > 0 {
+		port := C.ub4(options.Port)
+		err = conn.ociAttrSet(handle, C.OCI_HTYPE_SUBSCRIPTION, unsafe.Pointer(&port), 0, C.OCI_ATTR_SUBSCR_PORTNO)
+		if err != nil {
+			return fmt.Errorf("subscription port error: %v", err)
+		}
+	}
+
+	return nil
+}
+
+// newSubscription returns a subscription with a new id that is found by the notification callback
+func newSubscription(bufferSize int) *Subscription {
+	subscription := &Subscription{
+		id:     atomic.AddUint64(&subscriptionLastID, 1),
+		events: make(chan SubscriptionEvent, bufferSize),
+	}
+	subscriptions.Store(subscription.id, subscription)
+	return subscription
+}
+
+// Register executes query with args to register it, and its tables, with the subscription.
+// Returns the query id, used by QueryChange, when the subscription is query level, else 0.
+func (subscription *Subscription) Register(ctx context.Context, query string, args ...interface{}) (uint64, error) {
+	if subscription.closed {
+		return 0, errors.New("subscription is closed")
+	}
+
+	conn := subscription.conn
+	driverStmt, err := conn.PrepareContext(ctx, query)
+	if err != nil {
+		return 0, err
+	}
+	stmt := driverStmt.(*Stmt)
+	// the statement is registered each time it is executed, so it must not be reused from the statement cache
+	stmt.releaseMode = C.OCI_STRLS_CACHE_DELETE
+	defer stmt.Close()
+
+	err = conn.ociAttrSet(unsafe.Pointer(stmt.stmt), C.OCI_HTYPE_STMT, unsafe.Pointer(subscription.handle), 0, C.OCI_ATTR_CHNF_REGHANDLE)
+	if err != nil {
+		return 0, fmt.Errorf("statement subscription error: %v", err)
+	}
+
+	namedValues := make([]driver.NamedValue, len(args))
+	for i := 0; i < len(args); i++ {
+		namedValues[i].Ordinal = i + 1
+		namedValues[i].Value, err = driver.DefaultParameterConverter.ConvertValue(args[i])
+		if err != nil {
+			return 0, fmt.Errorf("convert value for argument %v - error: %v", i, err)
+		}
+	}
+
+	rows, err := stmt.QueryContext(ctx, namedValues)
+	if err != nil {
+		return 0, err
+	}
+	rows.Close()
+
+	var queryID C.ub8
+	if subscription.queryLevel {
+		_, err = stmt.ociAttrGet(unsafe.Pointer(&queryID), C.OCI_ATTR_CQ_QUERYID)
+		if err != nil {
+			return 0, fmt.Errorf("query id error: %v", err)
+		}
+	}
+
+	return uint64(queryID), nil
+}
+
+// RegisterTable registers table with the subscription by registering a query of all its rowids
+func (subscription *Subscription) RegisterTable(ctx context.Context, table string) error {
+	_, err := subscription.Register(ctx, "select rowid from "+table)
+	return err
+}
+
+// Events returns the channel change events are delivered on. It is closed by Close, or after an EventDeregister event.
+// Events are dropped when the channel is full, the next delivered event counts them in Missed.
+func (subscription *Subscription) Events() <-chan SubscriptionEvent {
+	return subscription.events
+}
+
+// Close unregisters the subscription and closes the Events channel.
+// A subscription removed by the database, after an EventDeregister event, is not unregistered again.
+func (subscription *Subscription) Close() error {
+	subscription.mutex.Lock()
+	closed := subscription.closed
+	deregistered := subscription.deregistered
+	subscription.mutex.Unlock()
+	if closed && !deregistered {
+		return nil
+	}
+
+	var err error
+	if !deregistered {
+		conn := subscription.conn
+		result := C.OCISubscriptionUnRegister(
+			conn.svc,            // service context
+			subscription.handle, // subscription handle
+			conn.errHandle,      // error handle
+			C.OCI_DEFAULT,       // mode
+		)
+		err = conn.getError(result)
+	}
+
+	subscription.stop()
+	subscription.free()
+
+	return err
+}
+
+// stop removes the subscription from the subscriptions found by the notification callback and closes the Events channel.
+// A callback running at the same time finishes first.
+func (subscription *Subscription) stop() {
+	subscriptions.Delete(subscription.id)
+
+	subscription.mutex.Lock()
+	if !subscription.closed {
+		subscription.closed = true
+		close(subscription.events)
+	}
+	subscription.mutex.Unlock()
+}
+
+// free frees the handles of the subscription
+func (subscription *Subscription) free() {
+	if subscription.handle != nil {
+		C.OCIHandleFree(unsafe.Pointer(subscription.handle), C.OCI_HTYPE_SUBSCRIPTION)
+		subscription.handle = nil
+	}
+	if subscription.errHandle != nil {
+		C.OCIHandleFree(unsafe.Pointer(subscription.errHandle), C.OCI_HTYPE_ERROR)
+		subscription.errHandle = nil
+	}
+}
+
+//export gobciSubscriptionNotify
+func gobciSubscriptionNotify(id C.uintptr_t, descriptor unsafe.Pointer) {
+	subscriptionNotify(uint64(id), descriptor)
+}
+
+// subscriptionNotify reads the change descriptor of a notification and delivers it to the subscription with id.
+// It is called by the notification callback on an OCI thread, and must not block: when Events is full the event is dropped.
+func subscriptionNotify(id uint64, descriptor unsafe.Pointer) {
+	value, ok := subscriptions.Load(id)
+	if !ok {
+		return
+	}
+	subscription := value.(*Subscription)
+
+	subscription.mutex.Lock()
+	defer subscription.mutex.Unlock()
+	if subscription.closed {
+		return
+	}
+
+	var event SubscriptionEvent
+	if descriptor != nil {
+		event = subscription.readEvent(descriptor)
+	}
+	subscription.deliver(event)
+}
+
+// deliver sends event on Events, or counts it as missed when Events is full.
+// After an EventDeregister event no more events follow, so Events is closed. The caller holds mutex.
+func (subscription *Subscription) deliver(event SubscriptionEvent) {
+	event.Missed = subscription.missed
+
+	select {
+	case subscription.events <- event:
+		subscription.missed = 0
+	default:
+		subscription.missed++
+	}
+
+	if event.Type == EventDeregister {
+		subscriptions.Delete(subscription.id)
+		subscription.deregistered = true
+		subscription.closed = true
+		close(subscription.events)
+	}
+}
+
+// readEvent reads a change notification descriptor
+func (subscription *Subscription) readEvent(descriptor unsafe.Pointer) SubscriptionEvent {
+	var event SubscriptionEvent
+	var eventType C.ub4
+	subscription.descriptorAttr(descriptor, C.OCI_DTYPE_CHDES, unsafe.Pointer(&eventType), nil, C.OCI_ATTR_CHDES_NFYTYPE)
+	event.Type = int(eventType)
+	event.Database = subscription.descriptorString(descriptor, C.OCI_DTYPE_CHDES, C.OCI_ATTR_CHDES_DBNAME)
+
+	switch event.Type {
+	case EventObjectChange:
+		event.Tables = subscription.readTables(descriptor, C.OCI_DTYPE_CHDES, C.OCI_ATTR_CHDES_TABLE_CHANGES)
+	case EventQueryChange:
+		var queries unsafe.Pointer
+		subscription.descriptorAttr(descriptor, C.OCI_DTYPE_CHDES, unsafe.Pointer(&queries), nil, C.OCI_ATTR_CHDES_QUERIES)
+		subscription.forEachDescriptor(queries, func(query unsafe.Pointer) {
+			var queryID C.ub8
+			var operation C.ub4
+			subscription.descriptorAttr(query, C.OCI_DTYPE_CQDES, unsafe.Pointer(&queryID), nil, C.OCI_ATTR_CQDES_QUERYID)
+			subscription.descriptorAttr(query, C.OCI_DTYPE_CQDES, unsafe.Pointer(&operation), nil, C.OCI_ATTR_CQDES_OPERATION)
+			event.Queries = append(event.Queries, QueryChange{
+				ID:        uint64(queryID),
+				Operation: int(operation),
+				Tables:    subscription.readTables(query, C.OCI_DTYPE_CQDES, C.OCI_ATTR_CQDES_TABLE_CHANGES),
+			})
+		})
+	}
+
+	return event
+}
+
+// readTables reads the table changes in the collection attribute of a change or query descriptor
+func (subscription *Subscription) readTables(descriptor unsafe.Pointer, descriptorType C.ub4, attributeType C.ub4) []TableChange {
+	var tables unsafe.Pointer
+	subscription.descriptorAttr(descriptor, descriptorType, unsafe.Pointer(&tables), nil, attributeType)
+
+	var tableChanges []TableChange
+	subscription.forEachDescriptor(tables, func(table unsafe.Pointer) {
+		var operation C.ub4
+		subscription.descriptorAttr(table, C.OCI_DTYPE_TABLE_CHDES, unsafe.Pointer(&operation), nil, C.OCI_ATTR_CHDES_TABLE_OPFLAGS)
+		tableChange := TableChange{
+			Name:      subscription.descriptorString(table, C.OCI_DTYPE_TABLE_CHDES, C.OCI_ATTR_CHDES_TABLE_NAME),
+			Operation: int(operation),
+		}
+
+		if operation&C.OCI_OPCODE_ALLROWS == 0 {
+			var rows unsafe.Pointer
+			subscription.descriptorAttr(table, C.OCI_DTYPE_TABLE_CHDES, unsafe.Pointer(&rows), nil, C.OCI_ATTR_CHDES_TABLE_ROW_CHANGES)
+			subscription.forEachDescriptor(rows, func(row unsafe.Pointer) {
+				var rowOperation C.ub4
+				subscription.descriptorAttr(row, C.OCI_DTYPE_ROW_CHDES, unsafe.Pointer(&rowOperation), nil, C.OCI_ATTR_CHDES_ROW_OPFLAGS)
+				tableChange.Rows = append(tableChange.Rows, RowChange{
+					Rowid:     subscription.descriptorString(row, C.OCI_DTYPE_ROW_CHDES, C.OCI_ATTR_CHDES_ROW_ROWID),
+					Operation: int(rowOperation),
+				})
+			})
+		}
+
+		tableChanges = append(tableChanges, tableChange)
+	})
+
+	return tableChanges
+}
+
+// forEachDescriptor calls f with each descriptor of a collection of change descriptors
+func (subscription *Subscription) forEachDescriptor(collection unsafe.Pointer, f func(descriptor unsafe.Pointer)) {
+	if collection == nil {
+		return
+	}
+	env := subscription.conn.env
+	count := C.ociCollDescriptorCount(env, subscription.errHandle, collection)
+	for i := C.sb4(0); i < count; i++ {
+		descriptor := C.ociCollDescriptor(env, subscription.errHandle, collection, i)
+		if descriptor != nil {
+			f(descriptor)
+		}
+	}
+}
+
+// descriptorAttr calls OCIAttrGet on a change descriptor with the error handle of the notification callback.
+// A missing attribute leaves value unchanged.
+func (subscription *Subscription) descriptorAttr(descriptor unsafe.Pointer, descriptorType C.ub4, value unsafe.Pointer, size *C.ub4, attributeType C.ub4) {
+	C.OCIAttrGet(
+		descriptor,             // Pointer to a descriptor type
+		descriptorType,         // The descriptor type
+		value,                  // Pointer to the storage for an attribute value
+		size,                   // The size of the attribute value
+		attributeType,          // The attribute type
+		subscription.errHandle, // An error handle
+	)
+}
+
+// descriptorString returns a text attribute of a change descriptor
+func (subscription *Subscription) descriptorString(descriptor unsafe.Pointer, descriptorType C.ub4, attributeType C.ub4) string {
+	var text *C.OraText
+	var size C.ub4
+	subscription.descriptorAttr(descriptor, descriptorType, unsafe.Pointer(&text), &size, attributeType)
+	if text == nil {
+		return ""
+	}
+	return C.GoStringN((*C.char)(unsafe.Pointer(text)), C.int(size))
+}
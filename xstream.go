@@ -0,0 +1,523 @@
+package gobci
+
+// #include "oci8.go.h"
+import "C"
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"time"
+	"unicode/utf16"
+	"unsafe"
+)
+
+const (
+	// LCRRow is the Type of row LCRs, DML changes and the COMMIT of transactions
+	LCRRow = C.OCI_LCR_XROW
+	// LCRDDL is the Type of DDL LCRs, only their header fields are set
+	LCRDDL = C.OCI_LCR_XDDL
+)
+
+// AttachXStreamOut attaches the connection to the XStream outbound server named server, so its LCRs can be received.
+// lastPosition is the Position of the last LCR the caller has durably processed, the server resends only LCRs after it.
+// nil resumes from the processed low watermark of the server, set by Acknowledge.
+// Until Detach the connection can not be used for anything else.
+// To get the driver Conn from a sql.Conn use sql.Conn.Raw
+func (conn *Conn) AttachXStreamOut(ctx context.Context, server string, lastPosition []byte) (*XStreamOut, error) {
+	if ctx.Err() != nil {
+		return nil, ctx.Err()
+	}
+
+	cServer := cString(server)
+	defer C.free(unsafe.Pointer(cServer))
+	var cPosition *C.ub1
+	if len(lastPosition) > 0 {
+		cPosition = (*C.ub1)(C.CBytes(lastPosition))
+		defer C.free(unsafe.Pointer(cPosition))
+	}
+
+	armed := conn.watchCancel(ctx)
+	result := C.OCIXStreamOutAttach(
+		conn.svc,                             // service context
+		conn.errHandle,                       // error handle
+		cServer,                              // outbound server name
+		C.ub2(len(server)),                   // outbound server name length
+		cPosition,                            // last position processed
+		C.ub2(len(lastPosition)),             // last position length
+		C.OCIXSTREAM_OUT_ATTACH_APP_FREE_LCR, // mode: LCRs are freed by ociLCRsFree
+	)
+	conn.unwatchCancel(armed)
+	err := conn.getError(result)
+	if err != nil {
+		return nil, fmt.Errorf("attach XStream Out server %v error: %v", server, err)
+	}
+
+	return &XStreamOut{
+		conn:     conn,
+		attached: true,
+	}, nil
+}
+
+// ensureCapacity makes the LCR arrays hold at least count LCRs
+func (stream *XStreamOut) ensureCapacity(count int) {
+	if count <= stream.capacity {
+		return
+	}
+	stream.freeArrays()
+
+	stream.lcrs = C.calloc(C.size_t(count), C.size_t(sizeOfNilPointer))
+	stream.types = C.calloc(C.size_t(count), C.sizeof_ub1)
+	stream.flags = C.calloc(C.size_t(count), C.sizeof_oraub8)
+	stream.headers = C.calloc(C.size_t(count), C.sizeof_ociLCRHeader)
+	stream.capacity = count
+}
+
+// ensureColumns makes the column array hold at least count columns
+func (stream *XStreamOut) ensureColumns(count int) {
+	if count <= stream.columnCount {
+		return
+	}
+	C.free(stream.columns)
+	stream.columns = C.calloc(C.size_t(count), C.sizeof_ociLCRColumn)
+	stream.columnCount = count
+}
+
+// Receive returns the next LCRs of the stream, at most max, waiting until at least one is available.
+// LCRs are received in batches of up to max per cgo call, and the chunks of LOB, LONG, and XMLType columns
+// are joined into the value of the column in NewColumns.
+// ctx is checked between receive calls, which return at least every idle timeout of the server, 1 second by default.
+// Returns nil LCRs and a nil error when the deadline of ctx is exceeded, and ctx.Err() when ctx is canceled.
+func (stream *XStreamOut) Receive(ctx context.Context, max int) ([]LCR, error) {
+	if !stream.attached {
+		return nil, errors.New("XStream Out is detached")
+	}
+	if max < 1 {
+		max = 1
+	}
+	if stream.columnCount == 0 {
+		stream.ensureColumns(256)
+	}
+	stream.ensureCapacity(max)
+
+	for {
+		switch ctx.Err() {
+		case nil:
+		case context.DeadlineExceeded:
+			return nil, nil
+		default:
+			return nil, ctx.Err()
+		}
+
+		count, err := stream.receive(max)
+		if err != nil {
+			return nil, err
+		}
+		if count == 0 {
+			continue
+		}
+
+		lcrs, err := stream.read(count)
+		if err == nil && stream.moreData(count) {
+			err = stream.receiveChunks(&lcrs[count-1])
+		}
+		C.ociLCRsFree(stream.conn.svc, stream.conn.errHandle, C.ub4(count), (*unsafe.Pointer)(stream.lcrs))
+		if err != nil {
+			return nil, err
+		}
+		return lcrs, nil
+	}
+}
+
+// receive receives up to max LCRs into the LCR arrays and returns how many.
+// When the receive call completes the fetch low position it returns is kept for LowWatermark.
+func (stream *XStreamOut) receive(max int) (int, error) {
+	conn := stream.conn
+	var count C.ub4
+	var lowPosition [C.OCI_LCR_MAX_POSITION_LEN]C.ub1
+	var lowPositionLength C.ub2
+
+	result := C.ociXStreamOutReceive(
+		conn.svc,                       // service context
+		conn.errHandle,                 // error handle
+		C.ub4(max),                     // max LCRs to receive
+		(*unsafe.Pointer)(stream.lcrs), // returns the LCRs
+		(*C.ub1)(stream.types),         // returns the LCR types
+		(*C.oraub8)(stream.flags),      // returns the LCR flags
+		&count,                         // returns the number of LCRs
+		&lowPosition[0],                // returns the fetch low position when the call completes
+		&lowPositionLength,             // returns the fetch low position length
+	)
+
+	switch result {
+	case C.OCI_STILL_EXECUTING:
+		stream.inCall = true
+	case C.OCI_SUCCESS:
+		stream.inCall = false
+		if lowPositionLength > 0 {
+			stream.lowPosition = C.GoBytes(unsafe.Pointer(&lowPosition[0]), C.int(lowPositionLength))
+		}
+	default:
+		stream.inCall = false
+		C.ociLCRsFree(conn.svc, conn.errHandle, count, (*unsafe.Pointer)(stream.lcrs))
+		return 0, fmt.Errorf("receive LCRs error: %v", conn.getError(result))
+	}
+
+	return int(count), nil
+}
+
+// moreData returns true if the last of count received LCRs has chunks to receive
+func (stream *XStreamOut) moreData(count int) bool {
+	flags := (*[1 << 28]C.oraub8)(stream.flags)[:count:count]
+	return flags[count-1]&C.OCI_XSTREAM_MORE_ROW_DATA != 0
+}
+
+// read decodes count received LCRs, reading their headers and columns with as few cgo calls as the column array allows
+func (stream *XStreamOut) read(count int) ([]LCR, error) {
+	conn := stream.conn
+	lcrs := make([]LCR, count)
+	done := 0
+
+	for done < count {
+		var read C.ub4
+		var needed C.ub4
+		lcrPointers := unsafe.Pointer(uintptr(stream.lcrs) + uintptr(done)*sizeOfNilPointer)
+		lcrTypes := unsafe.Pointer(uintptr(stream.types) + uintptr(done))
+		result := C.ociLCRsRead(
+			conn.svc,                          // service context
+			conn.errHandle,                    // error handle
+			unsafe.Pointer(conn.env),          // environment handle
+			C.ub4(count-done),                 // number of LCRs
+			(*unsafe.Pointer)(lcrPointers),    // LCRs
+			(*C.ub1)(lcrTypes),                // LCR types
+			(*C.ociLCRHeader)(stream.headers), // returns the headers
+			(*C.ociLCRColumn)(stream.columns), // returns the columns
+			C.ub4(stream.columnCount),         // column capacity
+			&read,                             // returns the number of LCRs read
+			&needed,                           // returns the columns of the LCR that did not fit
+		)
+		if result == C.OCI8_GO_NO_MEMORY {
+			return nil, errors.New("read LCRs error: out of memory")
+		}
+		err := conn.getError(result)
+		if err != nil {
+			return nil, fmt.Errorf("read LCRs error: %v", err)
+		}
+
+		if read == 0 {
+			// the first LCR has more columns than the column array
+			if int(needed) <= stream.columnCount {
+				return nil, fmt.Errorf("LCR with %v columns could not be read", needed)
+			}
+			stream.ensureColumns(int(needed))
+			continue
+		}
+
+		headers := (*[1 << 24]C.ociLCRHeader)(stream.headers)[:read:read]
+		columns := (*[1 << 24]C.ociLCRColumn)(stream.columns)[:stream.columnCount:stream.columnCount]
+		for i := range headers {
+			lcr := &lcrs[done+i]
+			lcr.Type = int(*(*C.ub1)(unsafe.Pointer(uintptr(lcrTypes) + uintptr(i))))
+			stream.decodeHeader(lcr, &headers[i])
+			if lcr.Type != LCRRow {
+				continue
+			}
+			header := &headers[i]
+			lcr.OldColumns, err = stream.decodeColumns(columns[header.oldStart : header.oldStart+C.ub4(header.oldCount)])
+			if err != nil {
+				return nil, err
+			}
+			lcr.NewColumns, err = stream.decodeColumns(columns[header.newStart : header.newStart+C.ub4(header.newCount)])
+			if err != nil {
+				return nil, err
+			}
+		}
+		done += int(read)
+	}
+
+	return lcrs, nil
+}
+
+// decodeHeader sets the header fields of lcr
+func (stream *XStreamOut) decodeHeader(lcr *LCR, header *C.ociLCRHeader) {
+	lcr.Command = lcrString(header.command, header.commandLength)
+	lcr.SourceDatabase = lcrString(header.sourceDatabase, header.sourceDatabaseLength)
+	lcr.Owner = lcrString(header.owner, header.ownerLength)
+	lcr.Object = lcrString(header.object, header.objectLength)
+	lcr.TransactionID = lcrString(header.transactionID, header.transactionIDLength)
+	if header.tagLength > 0 {
+		lcr.Tag = C.GoBytes(unsafe.Pointer(header.tag), C.int(header.tagLength))
+	}
+	if header.positionLength > 0 {
+		lcr.Position = C.GoBytes(unsafe.Pointer(header.position), C.int(header.positionLength))
+	}
+	if header.sourceYear != 0 {
+		lcr.SourceTime = time.Date(int(header.sourceYear), time.Month(header.sourceMonth), int(header.sourceDay),
+			int(header.sourceHour), int(header.sourceMinute), int(header.sourceSecond), 0, stream.conn.timeLocation)
+	}
+}
+
+// decodeColumns converts the column values of a row LCR to LCRColumns
+func (stream *XStreamOut) decodeColumns(columns []C.ociLCRColumn) ([]LCRColumn, error) {
+	if len(columns) == 0 {
+		return nil, nil
+	}
+
+	lcrColumns := make([]LCRColumn, len(columns))
+	for i := range columns {
+		column := &columns[i]
+		lcrColumns[i].Name = lcrString(column.name, column.nameLength)
+		value, err := stream.decodeValue(column)
+		if err != nil {
+			return nil, fmt.Errorf("column %v - error: %v", lcrColumns[i].Name, err)
+		}
+		lcrColumns[i].Value = value
+	}
+
+	return lcrColumns, nil
+}
+
+// decodeValue converts a column value of a row LCR to a Go value, nil for NULL and unsupported types
+func (stream *XStreamOut) decodeValue(column *C.ociLCRColumn) (interface{}, error) {
+	if column.indicator == C.OCI_IND_NULL || column.value == nil {
+		return nil, nil
+	}
+
+	switch column.dataType {
+	case C.SQLT_CHR, C.SQLT_AFC, C.SQLT_VCS:
+		buffer := C.GoBytes(column.value, C.int(column.length))
+		if column.flags&C.OCI_LCR_COLUMN_AL16UTF16 != 0 {
+			return decodeAL16UTF16(buffer), nil
+		}
+		return string(buffer), nil
+	case C.SQLT_BIN:
+		return C.GoBytes(column.value, C.int(column.length)), nil
+	case C.SQLT_VNU:
+		// OCINumber is the length byte followed by the number
+		number := (*[22]byte)(column.value)
+		length := int(number[0])
+		if length > 21 {
+			return nil, fmt.Errorf("invalid number length %v", length)
+		}
+		return decodeNumber(number[1 : 1+length])
+	case C.SQLT_BFLOAT:
+		return float64(*(*C.float)(column.value)), nil
+	case C.SQLT_BDOUBLE:
+		return float64(*(*C.double)(column.value)), nil
+	case C.SQLT_ODT, C.SQLT_TIMESTAMP:
+		return stream.conn.dateTimeFieldsToTime(&column.dateTime, false), nil
+	case C.SQLT_TIMESTAMP_TZ, C.SQLT_TIMESTAMP_LTZ:
+		return stream.conn.dateTimeFieldsToTime(&column.dateTime, true), nil
+	case C.SQLT_INTERVAL_YM, C.SQLT_INTERVAL_DS:
+		return C.GoStringN((*C.char)(unsafe.Pointer(&column.text[0])), C.int(column.textLength)), nil
+	}
+
+	return nil, nil
+}
+
+// receiveChunks receives the chunks of the LOB, LONG, and XMLType columns of the last received LCR
+// and sets them as the values of its NewColumns. If lcr is nil the chunks are discarded.
+func (stream *XStreamOut) receiveChunks(lcr *LCR) error {
+	conn := stream.conn
+	type chunkedColumn struct {
+		index int
+		flags C.oraub8
+		text  bool
+		data  []byte
+	}
+	var chunkedColumns []*chunkedColumn
+
+	for {
+		var name *C.oratext
+		var nameLength C.ub2
+		var dataType C.ub2
+		var columnFlags C.oraub8
+		var charsetID C.ub2
+		var chunkLength C.ub4
+		var chunk *C.ub1
+		var flags C.oraub8
+
+		result := C.OCIXStreamOutChunkReceive(
+			conn.svc,       // service context
+			conn.errHandle, // error handle
+			&name,          // returns the column name
+			&nameLength,    // returns the column name length
+			&dataType,      // returns the column data type
+			&columnFlags,   // returns the column flags
+			&charsetID,     // returns the column character set id
+			&chunkLength,   // returns the chunk length
+			&chunk,         // returns the chunk data
+			&flags,         // returns OCI_XSTREAM_MORE_ROW_DATA if there are more chunks
+			C.OCI_DEFAULT,  // mode
+		)
+		err := conn.getError(result)
+		if err != nil {
+			return fmt.Errorf("receive chunk error: %v", err)
+		}
+
+		if lcr != nil && nameLength > 0 {
+			columnName := lcrString(name, nameLength)
+			var column *chunkedColumn
+			for _, chunked := range chunkedColumns {
+				if lcr.NewColumns[chunked.index].Name == columnName {
+					column = chunked
+					break
+				}
+			}
+			if column == nil {
+				column = &chunkedColumn{index: -1, flags: columnFlags}
+				for i := range lcr.NewColumns {
+					if lcr.NewColumns[i].Name == columnName {
+						column.index = i
+						break
+					}
+				}
+				if column.index < 0 {
+					lcr.NewColumns = append(lcr.NewColumns, LCRColumn{Name: columnName})
+					column.index = len(lcr.NewColumns) - 1
+				}
+				chunkedColumns = append(chunkedColumns, column)
+			}
+			if chunkLength > 0 {
+				column.data = append(column.data, C.GoBytes(unsafe.Pointer(chunk), C.int(chunkLength))...)
+			}
+			column.flags |= columnFlags
+			if dataType == C.SQLT_CHR {
+				column.text = true
+			}
+		}
+
+		if flags&C.OCI_XSTREAM_MORE_ROW_DATA == 0 {
+			break
+		}
+	}
+
+	for _, column := range chunkedColumns {
+		switch {
+		case column.flags&C.OCI_LCR_COLUMN_AL16UTF16 != 0:
+			lcr.NewColumns[column.index].Value = decodeAL16UTF16(column.data)
+		case column.text:
+			lcr.NewColumns[column.index].Value = string(column.data)
+		default:
+			if column.data == nil {
+				column.data = []byte{}
+			}
+			lcr.NewColumns[column.index].Value = column.data
+		}
+	}
+
+	return nil
+}
+
+// lcrString returns the text at pointer as a string
+func lcrString(pointer *C.oratext, length C.ub2) string {
+	if pointer == nil || length == 0 {
+		return ""
+	}
+	return C.GoStringN((*C.char)(unsafe.Pointer(pointer)), C.int(length))
+}
+
+// decodeAL16UTF16 decodes big endian UTF-16 text
+func decodeAL16UTF16(buffer []byte) string {
+	units := make([]uint16, len(buffer)/2)
+	for i := range units {
+		units[i] = uint16(buffer[2*i])<<8 | uint16(buffer[2*i+1])
+	}
+	return string(utf16.Decode(units))
+}
+
+// LowWatermark returns the fetch low position of the last completed receive call.
+// All transactions with a commit position at or below it have been received.
+func (stream *XStreamOut) LowWatermark() []byte {
+	return stream.lowPosition
+}
+
+// Acknowledge sets the processed low watermark, the Position of the last LCR the caller has durably processed.
+// It is sent to the server with the next receive call and on Detach, and the server will not resend LCRs at or below it,
+// so resuming with AttachXStreamOut and the same position gives exactly once processing.
+func (stream *XStreamOut) Acknowledge(position []byte) error {
+	if !stream.attached {
+		return errors.New("XStream Out is detached")
+	}
+	if len(position) == 0 {
+		return nil
+	}
+	if len(position) > C.OCI_LCR_MAX_POSITION_LEN {
+		return fmt.Errorf("position length %v is greater than %v", len(position), C.OCI_LCR_MAX_POSITION_LEN)
+	}
+
+	cPosition := C.CBytes(position)
+	defer C.free(cPosition)
+	result := C.OCIXStreamOutProcessedLWMSet(
+		stream.conn.svc,       // service context
+		stream.conn.errHandle, // error handle
+		(*C.ub1)(cPosition),   // processed low position
+		C.ub2(len(position)),  // processed low position length
+		C.OCI_DEFAULT,         // mode
+	)
+	err := stream.conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("set processed low watermark error: %v", err)
+	}
+
+	return nil
+}
+
+// Detach ends the current receive call, discarding the LCRs left in it, and detaches from the outbound server.
+// The processed low watermark set by Acknowledge is sent to the server before detaching.
+func (stream *XStreamOut) Detach() error {
+	if !stream.attached {
+		return nil
+	}
+	defer stream.free()
+	stream.attached = false
+
+	if stream.capacity == 0 {
+		stream.ensureCapacity(1)
+	}
+	for stream.inCall {
+		count, err := stream.receive(stream.capacity)
+		if err != nil {
+			return err
+		}
+		if count > 0 && stream.moreData(count) {
+			err = stream.receiveChunks(nil)
+		}
+		C.ociLCRsFree(stream.conn.svc, stream.conn.errHandle, C.ub4(count), (*unsafe.Pointer)(stream.lcrs))
+		if err != nil {
+			return err
+		}
+	}
+
+	result := C.OCIXStreamOutDetach(
+		stream.conn.svc,       // service context
+		stream.conn.errHandle, // error handle
+		C.OCI_DEFAULT,         // mode
+	)
+	err := stream.conn.getError(result)
+	if err != nil {
+		return fmt.Errorf("detach XStream Out error: %v", err)
+	}
+
+	return nil
+}
+
+// freeArrays frees the LCR arrays
+func (stream *XStreamOut) freeArrays() {
+	for _, buffer := range []unsafe.Pointer{stream.lcrs, stream.types, stream.flags, stream.headers} {
+		C.free(buffer)
+	}
+	stream.lcrs = nil
+	stream.types = nil
+	stream.flags = nil
+	stream.headers = nil
+	stream.capacity = 0
+}
+
+// free frees the LCR and column arrays
+func (stream *XStreamOut) free() {
+	stream.freeArrays()
+	C.free(stream.columns)
+	stream.columns = nil
+	stream.columnCount = 0
+}